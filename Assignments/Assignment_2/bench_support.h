@@ -0,0 +1,52 @@
+#ifndef BENCH_SUPPORT_H
+#define BENCH_SUPPORT_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Shared pieces of the benchmarks: a count of every heap allocation in the
+// process and a timer that reports it.
+//
+// The global operator new and delete are replaced here, and a program may
+// define them only once, so include this header from the benchmark's single
+// .cpp file and nowhere else. Allocation uses malloc and every form of
+// delete releases with free. The deletes are kept out of line: inlined into
+// a caller that got its pointer from a plain new-expression, GCC would see
+// that pointer reach free() and warn (-Wmismatched-new-delete).
+
+inline std::atomic<size_t> allocationCount(0);
+
+void* operator new(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+
+__attribute__((noinline)) void operator delete(void* p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete[](void* p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+// Wall time and heap allocations of one measured run
+struct RunCost {
+    double seconds = 0;
+    size_t allocations = 0;
+};
+
+// Function to call run() once, storing its cost; returns what run() returns
+template <typename Run>
+auto measureRun(Run run, RunCost& cost) {
+    size_t allocationsBefore = allocationCount.load();
+    auto start = std::chrono::steady_clock::now();
+    auto result = run();
+    cost.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    cost.allocations = allocationCount.load() - allocationsBefore;
+    return result;
+}
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef ERROR_LOG_H
+#define ERROR_LOG_H
+
+#include <cctype>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "lexer.h"
+
+// Collects lexical errors while scanning and prints them in one write at the
+// end. Only the first `limit` errors are kept; the rest are counted and
+// summarised, so a dirty input with thousands of bad bytes costs a counter
+// increment per byte instead of a flushed line of output. Positions come
+// from the token: the loop that skips a whitespace run (skipSpaces in
+// scanner_dfa.h, or its SSE2 version) also counts the newlines in it and
+// remembers the last one, which gives the Lexer the line and column without
+// a separate pass or newline index.
+
+#define ERROR_LOG_DEFAULT_LIMIT 100
+
+class ErrorLog {
+public:
+    explicit ErrorLog(size_t maxReported = ERROR_LOG_DEFAULT_LIMIT) : limit(maxReported) {}
+
+    // Function to record an error token and the byte that caused it
+    void add(const Token& token, char byte) {
+        if (entries.size() < limit) entries.push_back(Entry{token.line, token.col, byte});
+        total++;
+    }
+
+    size_t count() const { return total; }
+
+    // Function to format all kept errors plus the summary and write them at once
+    void flush(FILE* out) {
+        if (total == 0) return;
+        std::string text;
+        text.reserve(entries.size() * 64 + 128);
+        char line[128];
+        for (const Entry& entry : entries) {
+            if (isprint((unsigned char)entry.byte)) {
+                snprintf(line, sizeof(line), "Lexical Error: Unknown Symbol -> %c (line %u, col %u)\n",
+                         entry.byte, entry.line, entry.col);
+            } else {
+                snprintf(line, sizeof(line),
+                         "Lexical Error: Unknown Non-Printable Character 0x%02X Detected (line %u, col %u)\n",
+                         (unsigned char)entry.byte, entry.line, entry.col);
+            }
+            text += line;
+        }
+        if (total > entries.size()) {
+            snprintf(line, sizeof(line), "... %zu more lexical errors not shown\n", total - entries.size());
+            text += line;
+        }
+        snprintf(line, sizeof(line), "%zu lexical error%s in total\n", total, total == 1 ? "" : "s");
+        text += line;
+        fwrite(text.data(), 1, text.size(), out);
+        fflush(out);
+        entries.clear();
+        total = 0;
+    }
+
+private:
+    struct Entry {
+        uint32_t line;
+        uint32_t col;
+        char byte;
+    };
+
+    size_t limit;
+    size_t total = 0;
+    std::vector<Entry> entries;
+};
+
+#endif
@@ -0,0 +1,296 @@
+#ifndef INCREMENTAL_LEXER_H
+#define INCREMENTAL_LEXER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "lexer.h"
+
+// Keeps a text and its token array up to date under edits.
+//
+// The DFA always starts a lexeme in q0, and a lexeme's extent depends only on
+// its own bytes and the one byte after it. So tokens ending before an edit
+// cannot change, and once re-lexing after the edit starts a token exactly
+// where an old token started (shifted by the size change) the rest of the old
+// stream is valid again. applyEdit() re-lexes only that window and splices it
+// in.
+//
+// Both the text and the token array are gap buffers whose gap follows the
+// edits. Tokens behind the gap store their offset and line counted back from
+// the end of the text, so an edit in front of them moves them without
+// touching them. The cost of an edit is the re-lexed window plus the distance
+// the gaps move, which is small when edits stay near each other.
+
+#define INCREMENTAL_MIN_GAP 4096    // Spare bytes / tokens kept in each gap
+#define INCREMENTAL_MIN_WINDOW 256  // First re-lex window past the edit
+
+struct TextEdit {
+    uint64_t offset;            // Where the edit starts in the current text
+    uint64_t deleted;           // Bytes removed at offset
+    std::string_view inserted;  // Bytes inserted at offset
+};
+
+struct EditResult {
+    size_t firstToken = 0;      // Index of the first token that was re-lexed
+    size_t removedTokens = 0;   // Old tokens replaced
+    size_t insertedTokens = 0;  // New tokens spliced in their place
+    uint64_t bytesRelexed = 0;  // Bytes the DFA had to scan
+};
+
+class IncrementalLexer {
+public:
+    explicit IncrementalLexer(std::string_view initialText, const KeywordSet& kw = defaultKeywords)
+        : keywords(&kw) {
+        std::string text(initialText);
+        chars.assign(text.begin(), text.end());
+        gapBegin = chars.size();
+        chars.resize(chars.size() + INCREMENTAL_MIN_GAP);
+        gapEnd = chars.size();
+        totalLines = 1 + (uint32_t)std::count(text.begin(), text.end(), '\n');
+
+        Lexer lexer(text.data(), text.size(), *keywords);
+        for (Token token = lexer.next(); token.kind != TokenKind::End; token = lexer.next()) {
+            tokenBuffer.push_back(token);
+        }
+        tokenGapBegin = tokenBuffer.size();
+        tokenBuffer.resize(tokenBuffer.size() + INCREMENTAL_MIN_GAP);
+        tokenGapEnd = tokenBuffer.size();
+    }
+
+    uint64_t size() const { return chars.size() - (gapEnd - gapBegin); }
+    size_t tokenCount() const { return tokenBuffer.size() - (tokenGapEnd - tokenGapBegin); }
+
+    // Function to read token i with absolute offset and line
+    Token token(size_t i) const {
+        if (i < tokenGapBegin) return tokenBuffer[i];
+        Token token = tokenBuffer[i + (tokenGapEnd - tokenGapBegin)];
+        token.offset = size() - token.offset;
+        token.line = totalLines - token.line;
+        return token;
+    }
+
+    // Function to copy out the whole text (linear; for checks and saving)
+    std::string text() const { return copyText(0, size()); }
+
+    // Function to copy out all tokens (linear; for checks and saving)
+    std::vector<Token> tokens() const {
+        std::vector<Token> all(tokenCount());
+        for (size_t i = 0; i < all.size(); i++) all[i] = token(i);
+        return all;
+    }
+
+    std::string lexeme(const Token& token) const { return copyText(token.offset, token.length); }
+
+    // Function to apply one edit and re-lex the part of the text it can affect
+    EditResult applyEdit(const TextEdit& edit) {
+        EditResult result;
+        uint64_t oldSize = size();
+        uint64_t offset = std::min<uint64_t>(edit.offset, oldSize);
+        uint64_t deleted = std::min<uint64_t>(edit.deleted, oldSize - offset);
+        uint64_t newEditEnd = offset + edit.inserted.size();
+
+        // Restart at the first token that ends at or after the edit (its end
+        // byte may have changed); past the last token, re-lex the last one
+        size_t first = firstTokenEndingAtOrAfter(offset);
+        if (first == tokenCount() && first > 0) first--;
+
+        uint64_t restart = 0;
+        uint32_t startLine = 1;
+        uint64_t startLineStart = 0;
+        if (first < tokenCount()) {
+            Token anchor = token(first);
+            restart = std::min(anchor.offset, offset);
+            startLine = anchor.line;
+            startLineStart = anchor.offset - (anchor.col - 1);
+            if (restart < anchor.offset) {
+                // The edit starts in the spaces before the anchor; count back to the restart
+                for (uint64_t at = restart; at < anchor.offset; at++) {
+                    if (charAt(at) == '\n') startLine--;
+                }
+                if (startLine != anchor.line) startLineStart = lineStartBefore(restart);
+            }
+        }
+
+        // Old tokens from `first` on move behind the gap before the text changes,
+        // so they shift along with the edit
+        moveTokenGap(first);
+
+        uint32_t removedLines = 0;
+        for (uint64_t at = offset; at < offset + deleted; at++) {
+            if (charAt(at) == '\n') removedLines++;
+        }
+        replaceText(offset, deleted, edit.inserted);
+        totalLines = totalLines - removedLines +
+                     (uint32_t)std::count(edit.inserted.begin(), edit.inserted.end(), '\n');
+
+        // Re-lex a window of the new text until a token lines up with an old one
+        uint64_t window = std::max<uint64_t>(INCREMENTAL_MIN_WINDOW, 2 * (newEditEnd - restart));
+        std::vector<Token> fresh;
+        size_t sync;
+        bool synced;
+        Token meet;
+        while (true) {
+            uint64_t windowEnd = std::min<uint64_t>(size(), restart + window);
+            scratch = copyText(restart, windowEnd - restart);
+            Lexer lexer(scratch.data(), scratch.size(), *keywords, restart);
+            lexer.startAt(startLine, startLineStart);
+
+            fresh.clear();
+            sync = first;
+            synced = false;
+            bool complete = true;
+            for (meet = lexer.next(); meet.kind != TokenKind::End; meet = lexer.next()) {
+                if (meet.offset >= newEditEnd) {
+                    while (sync < tokenCount() && shiftedOffset(sync) < meet.offset) sync++;
+                    if (sync < tokenCount() && shiftedOffset(sync) == meet.offset) {
+                        synced = true;
+                        break;
+                    }
+                }
+                if (meet.offset + meet.length >= windowEnd && windowEnd < size()) {
+                    complete = false;  // May continue past the window
+                    break;
+                }
+                fresh.push_back(meet);
+            }
+            if (!synced && complete && windowEnd < size()) complete = false;
+            if (synced || complete) {
+                result.bytesRelexed = (synced ? meet.offset : windowEnd) - restart;
+                break;
+            }
+            window *= 4;
+        }
+        if (!synced) sync = tokenCount();
+
+        // Tokens on the line where the streams met keep their line but may move sideways
+        if (synced) {
+            Token old = token(sync);
+            int64_t colDelta = (int64_t)meet.col - (int64_t)old.col;
+            if (colDelta != 0) {
+                size_t gapSize = tokenGapEnd - tokenGapBegin;
+                for (size_t i = sync; i < tokenCount() && token(i).line == old.line; i++) {
+                    tokenBuffer[i + gapSize].col = (uint32_t)(tokenBuffer[i + gapSize].col + colDelta);
+                }
+            }
+        }
+
+        // Drop the replaced tokens from the front of the tail and put the new ones before the gap
+        tokenGapEnd += sync - first;
+        reserveTokenGap(fresh.size());
+        for (const Token& token : fresh) tokenBuffer[tokenGapBegin++] = token;
+
+        result.firstToken = first;
+        result.removedTokens = sync - first;
+        result.insertedTokens = fresh.size();
+        return result;
+    }
+
+private:
+    const KeywordSet* keywords;
+    std::vector<char> chars;        // Text with a gap at [gapBegin, gapEnd)
+    size_t gapBegin = 0, gapEnd = 0;
+    std::vector<Token> tokenBuffer; // Tokens with a gap at [tokenGapBegin, tokenGapEnd)
+    size_t tokenGapBegin = 0, tokenGapEnd = 0;
+    uint32_t totalLines = 1;        // Lines in the text; tail tokens count lines back from it
+    std::string scratch;            // Contiguous copy of the re-lex window
+
+    char charAt(uint64_t at) const { return at < gapBegin ? chars[at] : chars[at + (gapEnd - gapBegin)]; }
+
+    std::string copyText(uint64_t from, uint64_t length) const {
+        std::string out(length, '\0');
+        uint64_t frontPart = from < gapBegin ? std::min<uint64_t>(length, gapBegin - from) : 0;
+        if (frontPart) memcpy(&out[0], chars.data() + from, frontPart);
+        if (length > frontPart) {
+            memcpy(&out[frontPart], chars.data() + (from + frontPart) + (gapEnd - gapBegin), length - frontPart);
+        }
+        return out;
+    }
+
+    uint64_t lineStartBefore(uint64_t at) const {
+        while (at > 0 && charAt(at - 1) != '\n') at--;
+        return at;
+    }
+
+    // Offset of token i in the new text, valid for tokens behind the gap
+    uint64_t shiftedOffset(size_t i) const {
+        return size() - tokenBuffer[i + (tokenGapEnd - tokenGapBegin)].offset;
+    }
+
+    size_t firstTokenEndingAtOrAfter(uint64_t at) const {
+        size_t lo = 0, hi = tokenCount();
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            Token t = token(mid);
+            if (t.offset + t.length < at) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+    void moveTextGap(uint64_t at) {
+        if (at < gapBegin) {
+            size_t count = gapBegin - at;
+            memmove(chars.data() + gapEnd - count, chars.data() + at, count);
+            gapBegin -= count;
+            gapEnd -= count;
+        } else if (at > gapBegin) {
+            size_t count = at - gapBegin;
+            memmove(chars.data() + gapBegin, chars.data() + gapEnd, count);
+            gapBegin += count;
+            gapEnd += count;
+        }
+    }
+
+    void reserveTextGap(size_t needed) {
+        if (gapEnd - gapBegin >= needed) return;
+        size_t tail = chars.size() - gapEnd;
+        size_t newSize = std::max(chars.size() * 2, chars.size() + needed + INCREMENTAL_MIN_GAP);
+        chars.resize(newSize);
+        memmove(chars.data() + newSize - tail, chars.data() + gapEnd, tail);
+        gapEnd = newSize - tail;
+    }
+
+    void replaceText(uint64_t offset, uint64_t deleted, std::string_view inserted) {
+        moveTextGap(offset);
+        gapEnd += deleted;
+        reserveTextGap(inserted.size());
+        memcpy(chars.data() + gapBegin, inserted.data(), inserted.size());
+        gapBegin += inserted.size();
+    }
+
+    // Function to move the token gap to index `at`, converting tokens that change sides
+    void moveTokenGap(size_t at) {
+        uint64_t textSize = size();
+        while (tokenGapBegin > at) {
+            Token token = tokenBuffer[--tokenGapBegin];
+            token.offset = textSize - token.offset;
+            token.line = totalLines - token.line;
+            tokenBuffer[--tokenGapEnd] = token;
+        }
+        while (tokenGapBegin < at) {
+            Token token = tokenBuffer[tokenGapEnd++];
+            token.offset = textSize - token.offset;
+            token.line = totalLines - token.line;
+            tokenBuffer[tokenGapBegin++] = token;
+        }
+    }
+
+    void reserveTokenGap(size_t needed) {
+        if (tokenGapEnd - tokenGapBegin >= needed) return;
+        size_t tail = tokenBuffer.size() - tokenGapEnd;
+        size_t newSize = std::max(tokenBuffer.size() * 2, tokenBuffer.size() + needed + INCREMENTAL_MIN_GAP);
+        tokenBuffer.resize(newSize);
+        std::move_backward(tokenBuffer.begin() + tokenGapEnd, tokenBuffer.begin() + tokenGapEnd + tail,
+                           tokenBuffer.end());
+        tokenGapEnd = newSize - tail;
+    }
+};
+
+#endif
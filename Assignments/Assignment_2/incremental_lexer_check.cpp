@@ -0,0 +1,97 @@
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "incremental_lexer.h"
+
+using namespace std;
+
+// Randomized check of IncrementalLexer: applies random edits to random
+// programs and after every edit compares the text and every token (kind,
+// offset, length, line, column) with a full re-lex of the same text.
+// Build: g++ -O2 -std=c++17 incremental_lexer_check.cpp -o incremental_lexer_check
+// Usage: ./incremental_lexer_check [texts] [edits per text] [seed]
+
+// Pieces the texts and inserted snippets are built from, including bytes
+// outside the language and runs that merge with their neighbours
+static const char* pieces[] = {"int", "while", "x", "count_1", "_t", "42", "3.14", "7.", "0", "=", "==",
+                               "!=", "<", ">=", "+", "-", "*", "/", "%", "#", "(", ")", "{", "}",
+                               "@", "$", ".", " ", "  ", "\t", "\n", "\n    ", "\r\n"};
+static const size_t numPieces = sizeof(pieces) / sizeof(pieces[0]);
+
+// Function to make a random string of `count` pieces
+string randomPieces(mt19937& rng, size_t count) {
+    string text;
+    for (size_t i = 0; i < count; i++) text += pieces[rng() % numPieces];
+    return text;
+}
+
+// Function to lex a whole text from scratch
+vector<Token> fullLex(const string& text) {
+    vector<Token> tokens;
+    Lexer lexer(text.data(), text.size());
+    for (Token token = lexer.next(); token.kind != TokenKind::End; token = lexer.next()) tokens.push_back(token);
+    return tokens;
+}
+
+bool sameToken(const Token& a, const Token& b) {
+    return a.kind == b.kind && a.offset == b.offset && a.length == b.length && a.line == b.line && a.col == b.col;
+}
+
+// Function to compare the incremental state with a full re-lex; prints the first difference
+bool matches(const IncrementalLexer& lexer, const string& expected, size_t text, size_t edit) {
+    if (lexer.text() != expected) {
+        cout << "Text " << text << ", edit " << edit << ": text differs" << endl;
+        return false;
+    }
+    vector<Token> want = fullLex(expected);
+    vector<Token> got = lexer.tokens();
+    for (size_t i = 0; i < want.size() || i < got.size(); i++) {
+        if (i < want.size() && i < got.size() && sameToken(want[i], got[i])) continue;
+        cout << "Text " << text << ", edit " << edit << ": token " << i << " differs (" << got.size() << " tokens, "
+             << want.size() << " expected)" << endl;
+        if (i < want.size()) {
+            cout << "  expected " << tokenKindName(want[i].kind) << " at " << want[i].offset << " length "
+                 << want[i].length << " line " << want[i].line << " col " << want[i].col << endl;
+        }
+        if (i < got.size()) {
+            cout << "  got      " << tokenKindName(got[i].kind) << " at " << got[i].offset << " length "
+                 << got[i].length << " line " << got[i].line << " col " << got[i].col << endl;
+        }
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    size_t texts = argc > 1 ? stoul(argv[1]) : 200;
+    size_t edits = argc > 2 ? stoul(argv[2]) : 200;
+    mt19937 rng(argc > 3 ? stoul(argv[3]) : 12345);
+
+    for (size_t t = 0; t < texts; t++) {
+        string expected = randomPieces(rng, rng() % 400);
+        IncrementalLexer lexer(expected);
+        if (!matches(lexer, expected, t, 0)) return 1;
+
+        uint64_t last = 0;
+        for (size_t e = 1; e <= edits; e++) {
+            // Mostly edits near the previous one, as when typing, sometimes anywhere
+            uint64_t offset;
+            if (rng() % 4 == 0 || expected.empty()) {
+                offset = expected.empty() ? 0 : rng() % (expected.size() + 1);
+            } else {
+                offset = min<uint64_t>(expected.size(), last + rng() % 16);
+                offset -= min<uint64_t>(offset, rng() % 16);
+            }
+            uint64_t deleted = rng() % 3 == 0 ? 0 : min<uint64_t>(expected.size() - offset, rng() % 12);
+            string inserted = rng() % 3 == 0 ? string() : randomPieces(rng, 1 + rng() % 4);
+
+            lexer.applyEdit(TextEdit{offset, deleted, inserted});
+            expected.replace(offset, deleted, inserted);
+            last = offset;
+            if (!matches(lexer, expected, t, e)) return 1;
+        }
+    }
+    cout << texts * edits << " edits on " << texts << " texts match a full re-lex" << endl;
+    return 0;
+}
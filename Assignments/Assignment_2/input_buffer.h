@@ -0,0 +1,182 @@
+#ifndef INPUT_BUFFER_H
+#define INPUT_BUFFER_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Input layer for the scanner.
+//
+// Regular files are memory-mapped in one piece, so the whole file is a single
+// window and refill() never has anything to do. Pipes and stdin go through a
+// two-half buffer: when the scanner runs into the end of the window, the half
+// holding the unfinished lexeme is kept and the other half is reloaded, so a
+// lexeme that straddles a read boundary stays contiguous in memory.
+//
+// In both modes data()[size()] is a '\0' sentinel followed by at least
+// INPUT_PADDING readable zero bytes, so the scanner can look ahead without
+// bounds checks and only has to compare positions when it sees a '\0'.
+
+#define INPUT_HALF_SIZE (1 << 16)  // Bytes reloaded per refill on stream input
+#define INPUT_PADDING 64           // Readable zero bytes after the window
+
+class InputBuffer {
+public:
+    InputBuffer() {}
+    ~InputBuffer() { close(); }
+
+    InputBuffer(const InputBuffer&) = delete;
+    InputBuffer& operator=(const InputBuffer&) = delete;
+
+    // Open a file for scanning; "-" reads from stdin
+    bool open(const char* path) { return openFile(path, true); }
+
+    // Open a file through the two-half buffer even if it could be mapped,
+    // e.g. to measure the stream path on a regular file
+    bool openStream(const char* path) { return openFile(path, false); }
+
+    void close() {
+        if (mapped) {
+            munmap(mapped, mappedLength);
+            mapped = nullptr;
+        }
+        free(buffer);
+        buffer = nullptr;
+        if (ownsFd && fd >= 0) ::close(fd);
+        fd = -1;
+        ownsFd = false;
+        window = emptyWindow;
+        length = 0;
+        windowBase = 0;
+        eof = true;
+    }
+
+    const char* data() const { return window; }
+    size_t size() const { return length; }
+    uint64_t base() const { return windowBase; }  // File offset of data()[0]
+    bool isMapped() const { return mapped != nullptr; }
+    bool atEof() const { return eof; }
+
+    // Drop everything before `keep` and read more input behind the rest.
+    // Positions held by the caller must be shifted down by `keep` afterwards.
+    // Returns false when no new bytes could be read.
+    bool refill(size_t keep) {
+        if (eof) return false;
+
+        size_t tail = length - keep;
+        if (tail > INPUT_HALF_SIZE) {
+            // A single lexeme longer than a half: grow instead of losing it
+            size_t newCapacity = capacity * 2;
+            char* grown = (char*)realloc(buffer, newCapacity + INPUT_PADDING + 1);
+            if (!grown) return false;
+            buffer = grown;
+            capacity = newCapacity;
+        }
+        memmove(buffer, buffer + keep, tail);
+        windowBase += keep;
+        length = tail;
+
+        size_t target = tail + INPUT_HALF_SIZE;
+        if (target > capacity) target = capacity;
+        while (length < target) {
+            ssize_t got = ::read(fd, buffer + length, target - length);
+            if (got < 0) {
+                if (errno == EINTR) continue;
+                eof = true;
+                break;
+            }
+            if (got == 0) {
+                eof = true;
+                break;
+            }
+            length += (size_t)got;
+        }
+        memset(buffer + length, 0, INPUT_PADDING + 1);
+        window = buffer;
+        return length > tail;
+    }
+
+private:
+    static constexpr char emptyWindow[INPUT_PADDING + 1] = {};
+
+    int fd = -1;
+    bool ownsFd = false;
+    char* mapped = nullptr;     // Base of the mapping in mmap mode
+    size_t mappedLength = 0;
+    char* buffer = nullptr;     // Two-half buffer in stream mode
+    size_t capacity = 0;        // Usable bytes in buffer (two halves)
+    const char* window = emptyWindow;
+    size_t length = 0;
+    uint64_t windowBase = 0;
+    bool eof = true;
+
+    // Function to open a file, mapping it only if mapRegular is set and it is a regular file
+    bool openFile(const char* path, bool mapRegular) {
+        close();
+        if (strcmp(path, "-") == 0) {
+            fd = STDIN_FILENO;
+            ownsFd = false;
+        } else {
+            fd = ::open(path, O_RDONLY);
+            if (fd < 0) return false;
+            ownsFd = true;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) == 0 && mapRegular && S_ISREG(st.st_mode) && mapFile((size_t)st.st_size)) {
+            return true;
+        }
+        return startStream();
+    }
+
+    // Map the file followed by an anonymous zero page that acts as sentinel
+    // and padding, so the file size never has to be a non-multiple of the page
+    bool mapFile(size_t fileSize) {
+        if (fileSize == 0) {
+            window = emptyWindow;
+            length = 0;
+            eof = true;
+            return true;
+        }
+        size_t page = (size_t)sysconf(_SC_PAGESIZE);
+        size_t fileSpan = (fileSize + page - 1) / page * page;
+        size_t total = fileSpan + page;
+
+        void* region = mmap(nullptr, total, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (region == MAP_FAILED) return false;
+        void* view = mmap(region, fileSize, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0);
+        if (view == MAP_FAILED) {
+            munmap(region, total);
+            return false;
+        }
+        madvise(view, fileSize, MADV_SEQUENTIAL);
+
+        mapped = (char*)region;
+        mappedLength = total;
+        window = mapped;
+        length = fileSize;
+        windowBase = 0;
+        eof = true;
+        return true;
+    }
+
+    bool startStream() {
+        capacity = 2 * INPUT_HALF_SIZE;
+        buffer = (char*)malloc(capacity + INPUT_PADDING + 1);
+        if (!buffer) return false;
+        window = buffer;
+        length = 0;
+        windowBase = 0;
+        eof = false;
+        refill(0);
+        return true;
+    }
+};
+
+#endif
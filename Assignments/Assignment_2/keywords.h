@@ -0,0 +1,125 @@
+#ifndef KEYWORDS_H
+#define KEYWORDS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Reserved-word recognizer built on a perfect hash.
+//
+// build() searches for a hash seed under which every keyword lands in its own
+// slot, so contains() is a length check, one hash over at most
+// KEYWORD_MAX_LENGTH bytes and a single slot compare: no probing and no heap.
+// The default keyword set is built at compile time; a set read from a config
+// file goes through the same search at startup and is just as fast.
+
+#define KEYWORD_MAX_LENGTH 15   // Longer identifiers are never keywords
+#define KEYWORD_MAX_SLOTS 256   // Room for up to 128 keywords at half load
+
+class KeywordSet {
+public:
+    // Function to build the table; fails on too many, too long or duplicate words
+    constexpr bool build(const std::string_view* words, size_t wordCount) {
+        if (wordCount > KEYWORD_MAX_SLOTS / 2) return false;
+        for (size_t i = 0; i < wordCount; i++) {
+            if (words[i].empty() || words[i].size() > KEYWORD_MAX_LENGTH) return false;
+            for (size_t j = 0; j < i; j++) {
+                if (words[i] == words[j]) return false;
+            }
+        }
+
+        uint32_t tableSize = 8;
+        while (tableSize < 2 * wordCount) tableSize *= 2;
+        for (; tableSize <= KEYWORD_MAX_SLOTS; tableSize *= 2) {
+            for (uint32_t trySeed = 1; trySeed <= 4096; trySeed++) {
+                if (tryBuild(words, wordCount, trySeed, tableSize - 1)) return true;
+            }
+        }
+        return false;
+    }
+
+    // Function to check if the bytes [p, p + n) spell a keyword
+    bool contains(const char* p, size_t n) const {
+        if (n - 1 >= KEYWORD_MAX_LENGTH) return false;  // Also rejects n == 0
+        const Slot& slot = slots[hash(p, n, seed) & mask];
+        return slot.length == n && memcmp(slot.text, p, n) == 0;
+    }
+
+    bool contains(std::string_view word) const { return contains(word.data(), word.size()); }
+
+    constexpr size_t size() const { return count; }
+
+    // Function to read whitespace-separated keywords from a config file
+    bool loadFile(const std::string& filename) {
+        std::ifstream file(filename);
+        if (!file.is_open()) return false;
+
+        std::vector<std::string> words;
+        std::string word;
+        while (file >> word) words.push_back(word);
+
+        std::vector<std::string_view> views(words.begin(), words.end());
+        KeywordSet loaded;
+        if (!loaded.build(views.data(), views.size())) return false;
+        *this = loaded;
+        return true;
+    }
+
+private:
+    struct Slot {
+        uint8_t length;  // 0 marks an empty slot
+        char text[KEYWORD_MAX_LENGTH];
+    };
+
+    Slot slots[KEYWORD_MAX_SLOTS] = {};
+    uint32_t seed = 0;
+    uint32_t mask = 0;
+    size_t count = 0;
+
+    static constexpr uint32_t hash(const char* p, size_t n, uint32_t seed) {
+        uint32_t h = seed ^ (uint32_t)n * 0x9E3779B1u;
+        for (size_t i = 0; i < n; i++) {
+            h = (h ^ (unsigned char)p[i]) * 0x01000193u;
+        }
+        h ^= h >> 15;
+        h *= 0x2C1B3C6Du;
+        h ^= h >> 12;
+        return h;
+    }
+
+    constexpr bool tryBuild(const std::string_view* words, size_t n, uint32_t trySeed, uint32_t tryMask) {
+        for (uint32_t i = 0; i <= tryMask; i++) slots[i] = Slot{};
+        for (size_t i = 0; i < n; i++) {
+            Slot& slot = slots[hash(words[i].data(), words[i].size(), trySeed) & tryMask];
+            if (slot.length != 0) return false;
+            slot.length = (uint8_t)words[i].size();
+            for (size_t k = 0; k < words[i].size(); k++) slot.text[k] = words[i][k];
+        }
+        seed = trySeed;
+        mask = tryMask;
+        count = n;
+        return true;
+    }
+};
+
+// List of reserved keywords
+inline constexpr std::string_view defaultKeywordList[] = {
+    "int", "float", "string", "if", "else", "while", "return"
+};
+
+// Function to build the default keyword table at compile time
+constexpr KeywordSet makeDefaultKeywords() {
+    KeywordSet set;
+    set.build(defaultKeywordList, sizeof(defaultKeywordList) / sizeof(defaultKeywordList[0]));
+    return set;
+}
+
+inline constexpr KeywordSet defaultKeywords = makeDefaultKeywords();
+static_assert(defaultKeywords.size() == sizeof(defaultKeywordList) / sizeof(defaultKeywordList[0]),
+              "no perfect hash found for the default keywords");
+
+#endif
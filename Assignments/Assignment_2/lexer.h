@@ -0,0 +1,165 @@
+#ifndef LEXER_H
+#define LEXER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "input_buffer.h"
+#include "keywords.h"
+#include "scanner_dfa.h"
+#include "scanner_simd.h"
+
+// Pull-style token stream over the scanner DFA.
+//
+// next() hands out plain Token values; the lexeme text is never copied and is
+// read back with text(), which points into the input buffer. For memory-mapped
+// files and in-memory ranges that view lives as long as the input; on stream
+// input it is only valid until the next call to next().
+
+struct Token {
+    TokenKind kind;
+    uint64_t offset;  // Byte offset of the lexeme in the input
+    uint32_t length;  // Lexeme length in bytes
+    uint32_t line;    // 1-based line of the first byte
+    uint32_t col;     // 1-based byte column of the first byte
+};
+
+// Function to get the token name used in tokens.txt
+inline const char* tokenKindName(TokenKind kind) {
+    switch (kind) {
+    case TokenKind::Identifier: return "Identifier";
+    case TokenKind::ReservedWord: return "Reserved Word";
+    case TokenKind::Integer: return "Integer";
+    case TokenKind::Float: return "Float Number";
+    case TokenKind::Operator: return "Operator";
+    case TokenKind::StatementTerminator: return "Statement Terminator";
+    case TokenKind::Symbol: return "Symbol";
+    case TokenKind::Error: return "Error";
+    default: return "End";
+    }
+}
+
+class Lexer {
+public:
+    // Lex a file or stream, refilling the buffer as needed
+    explicit Lexer(InputBuffer& in, const KeywordSet& kw = defaultKeywords)
+        : input(&in), keywords(&kw), tape(in.data()), length(in.size()), base(in.base()) {}
+
+    // Lex bytes already in memory; data[size] must be readable and must end
+    // a lexeme (a '\0' or a space), which std::string and InputBuffer provide
+    Lexer(const char* data, size_t size, const KeywordSet& kw = defaultKeywords)
+        : keywords(&kw), tape(data), length(size) {}
+
+    // Lex a slice of a larger input that starts at byte `baseOffset`; lines are
+    // counted from 1 and columns from the start of the slice
+    Lexer(const char* data, size_t size, const KeywordSet& kw, uint64_t baseOffset)
+        : keywords(&kw), tape(data), length(size), base(baseOffset), lineStart(baseOffset) {}
+
+    // Function to scan the next token; returns a TokenKind::End token at the end of input
+    Token next() {
+        while (true) {
+            // Skip spaces, tabs, and new lines; runs longer than one byte go to the run kernel
+            const char* p = tape + pos;
+            if (scannerDfa.classOf[(unsigned char)*p] == C_SPACE) {
+                if (scannerDfa.classOf[(unsigned char)p[1]] != C_SPACE) {
+                    if (*p == '\n') {
+                        line++;
+                        lineStart = base + pos + 1;
+                    }
+                    p++;
+                } else {
+                    uint32_t newlines = 0;
+                    const char* lastNewline = nullptr;
+                    p = kernels->skipSpaces(p, tape + length, newlines, lastNewline);
+                    if (newlines) {
+                        line += newlines;
+                        lineStart = base + (lastNewline - tape) + 1;
+                    }
+                }
+                pos = p - tape;
+            }
+            if (pos >= length) {
+                if (refill()) continue;
+                return makeToken(TokenKind::End, pos, 0);
+            }
+
+            // Identifier and number runs are measured by the run kernels, the rest by the DFA
+            const char* lexemeEnd;
+            TokenKind kind;
+            bool endedOnNextByte = true;
+            unsigned charClass = scannerDfa.classOf[(unsigned char)*p];
+            if (charClass == C_LETTER) {
+                lexemeEnd = kernels->identifierEnd(p + 1, tape + length);
+                kind = TokenKind::Identifier;
+            } else if (charClass == C_DIGIT) {
+                lexemeEnd = kernels->digitsEnd(p + 1, tape + length);
+                kind = TokenKind::Integer;
+                if (*lexemeEnd == '.') {
+                    lexemeEnd = kernels->digitsEnd(lexemeEnd + 1, tape + length);
+                    kind = TokenKind::Float;
+                }
+            } else {
+                unsigned state;
+                lexemeEnd = runScannerDfa(p, state);
+                kind = scannerDfa.kindOf[state];
+                endedOnNextByte = state < DFA_INCLUSIVE;
+            }
+
+            // A lexeme cut short by the end of the buffer is rescanned after a refill
+            if (lexemeEnd == tape + length && endedOnNextByte && refill()) continue;
+
+            size_t lexemeLength = lexemeEnd - p;
+            if (kind == TokenKind::Identifier && keywords->contains(p, lexemeLength)) {
+                kind = TokenKind::ReservedWord;
+            }
+            Token token = makeToken(kind, pos, lexemeLength);
+            pos += lexemeLength;
+            return token;
+        }
+    }
+
+    // Function to set the line state when lexing starts in the middle of a line
+    void startAt(uint32_t startLine, uint64_t startLineStart) {
+        line = startLine;
+        lineStart = startLineStart;
+    }
+
+    // Function to force a run kernel set, e.g. to compare them in a benchmark or test
+    void setKernels(const ScanKernels& k) { kernels = &k; }
+
+    uint32_t currentLine() const { return line; }
+    uint64_t currentLineStart() const { return lineStart; }
+
+    // Function to get the lexeme of a token returned by next()
+    std::string_view text(const Token& token) const {
+        return std::string_view(tape + (token.offset - base), token.length);
+    }
+
+private:
+    InputBuffer* input = nullptr;  // Null when lexing an in-memory range
+    const KeywordSet* keywords;
+    const ScanKernels* kernels = &scanKernels();
+    const char* tape;
+    size_t length;
+    size_t pos = 0;
+    uint64_t base = 0;       // Input offset of tape[0]
+    uint32_t line = 1;
+    uint64_t lineStart = 0;  // Input offset of the first byte of the current line
+
+    Token makeToken(TokenKind kind, size_t at, size_t size) const {
+        uint64_t offset = base + at;
+        return Token{kind, offset, (uint32_t)size, line, (uint32_t)(offset - lineStart + 1)};
+    }
+
+    // Function to slide the buffer so the lexeme at pos stays and more input follows it
+    bool refill() {
+        if (!input || !input->refill(pos)) return false;
+        tape = input->data();
+        length = input->size();
+        base = input->base();
+        pos = 0;
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef PARALLEL_LEXER_H
+#define PARALLEL_LEXER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "lexer.h"
+
+// Multi-threaded lexing of an input that is fully in memory.
+//
+// The input is cut into chunks at positions no lexeme can span: right before
+// a '#', or at the first non-space byte after a space. The scanner is
+// context-free across such a cut, so every chunk can be lexed on its own.
+// Each chunk counts lines from 1; once all chunks are done the line numbers,
+// and the columns of tokens on a chunk's first line, are shifted by what the
+// earlier chunks saw. The result is token for token what a single Lexer gives.
+
+#define PARALLEL_MIN_CHUNK (1 << 20)  // Smaller inputs are not worth splitting
+#define PARALLEL_CHUNKS_PER_THREAD 4  // Extra chunks to even out the load
+
+struct LexChunk {
+    uint64_t begin = 0, end = 0;
+    std::vector<Token> tokens;
+    uint32_t newlines = 0;      // Newlines inside the chunk
+    uint64_t lastLineStart = 0; // Offset just past the last newline in the chunk
+};
+
+// Function to check if no lexeme can continue across the cut before data[at]
+inline bool isSafeCut(const char* data, size_t at) {
+    if (data[at] == '#') return true;
+    return scannerDfa.classOf[(unsigned char)data[at - 1]] == C_SPACE &&
+           scannerDfa.classOf[(unsigned char)data[at]] != C_SPACE;
+}
+
+// Function to cut [0, size) into about `count` chunks at safe positions
+inline std::vector<LexChunk> splitChunks(const char* data, size_t size, size_t count) {
+    std::vector<LexChunk> chunks;
+    uint64_t begin = 0;
+    for (size_t i = 1; i < count && begin < size; i++) {
+        size_t cut = std::max<size_t>(size / count * i, begin + 1);
+        while (cut < size && !isSafeCut(data, cut)) cut++;
+        if (cut >= size) break;
+        chunks.emplace_back();
+        chunks.back().begin = begin;
+        chunks.back().end = cut;
+        begin = cut;
+    }
+    chunks.emplace_back();
+    chunks.back().begin = begin;
+    chunks.back().end = size;
+    return chunks;
+}
+
+// Function to run `work(chunkIndex)` for every chunk on `threads` workers
+template <typename Work>
+void forEachChunk(size_t chunkCount, unsigned threads, Work work) {
+    std::atomic<size_t> nextChunk(0);
+    auto worker = [&]() {
+        for (size_t i = nextChunk++; i < chunkCount; i = nextChunk++) work(i);
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; t++) pool.emplace_back(worker);
+    worker();
+    for (auto& thread : pool) thread.join();
+}
+
+// Function to lex data[0, size) on `threads` threads, keeping the tokens per chunk.
+// data[size] must be readable and end a lexeme, as for the in-memory Lexer.
+inline std::vector<LexChunk> lexChunks(const char* data, size_t size, const KeywordSet& keywords,
+                                       unsigned threads) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t count = threads > 1 ? (size_t)threads * PARALLEL_CHUNKS_PER_THREAD : 1;
+    count = std::max<size_t>(1, std::min(count, size / PARALLEL_MIN_CHUNK));
+    std::vector<LexChunk> chunks = splitChunks(data, size, count);
+
+    forEachChunk(chunks.size(), threads, [&](size_t i) {
+        LexChunk& chunk = chunks[i];
+        Lexer lexer(data + chunk.begin, chunk.end - chunk.begin, keywords, chunk.begin);
+        chunk.tokens.reserve((chunk.end - chunk.begin) / 4);
+        for (Token token = lexer.next(); token.kind != TokenKind::End; token = lexer.next()) {
+            chunk.tokens.push_back(token);
+        }
+        chunk.newlines = lexer.currentLine() - 1;
+        chunk.lastLineStart = lexer.currentLineStart();
+    });
+
+    // Where each chunk starts in line numbering, from the chunks before it
+    std::vector<uint32_t> lineBase(chunks.size());
+    std::vector<uint64_t> lineStartAtBegin(chunks.size());
+    uint32_t lines = 0;
+    uint64_t lineStart = 0;
+    for (size_t i = 0; i < chunks.size(); i++) {
+        lineBase[i] = lines;
+        lineStartAtBegin[i] = lineStart;
+        lines += chunks[i].newlines;
+        if (chunks[i].newlines > 0) lineStart = chunks[i].lastLineStart;
+    }
+
+    forEachChunk(chunks.size(), threads, [&](size_t i) {
+        for (Token& token : chunks[i].tokens) {
+            if (token.line == 1) token.col = (uint32_t)(token.offset - lineStartAtBegin[i] + 1);
+            token.line += lineBase[i];
+        }
+    });
+    return chunks;
+}
+
+// Function to lex data[0, size) on `threads` threads into one token vector
+inline std::vector<Token> lexParallel(const char* data, size_t size, const KeywordSet& keywords,
+                                      unsigned threads) {
+    std::vector<LexChunk> chunks = lexChunks(data, size, keywords, threads);
+    size_t total = 0;
+    for (const auto& chunk : chunks) total += chunk.tokens.size();
+
+    std::vector<Token> tokens;
+    tokens.reserve(total);
+    for (auto& chunk : chunks) {
+        tokens.insert(tokens.end(), chunk.tokens.begin(), chunk.tokens.end());
+        std::vector<Token>().swap(chunk.tokens);
+    }
+    return tokens;
+}
+
+#endif
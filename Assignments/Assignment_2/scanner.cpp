@@ -1,122 +1,112 @@
 #include <iostream>
 #include <fstream>
-#include <cctype>
 #include <cstring>
+#include "error_log.h"
+#include "lexer.h"
+#include "parallel_lexer.h"
+#include "token_file.h"
 
 using namespace std;
 
-#define MAX_TAPE_SIZE 1000  // Maximum input size
-
-char inputTape[MAX_TAPE_SIZE];  // Input tape (character array)
-int start_point = 0, end_point = 0;  // Two pointers
-
-// List of reserved keywords
-string keywords[] = {"int", "float", "string", "if", "else", "while", "return"};
-int numKeywords = sizeof(keywords) / sizeof(keywords[0]);
-
-// Function to check if a string is a keyword
-bool isKeyword(string lexeme) {
-    for (int i = 0; i < numKeywords; i++) {
-        if (lexeme == keywords[i]) return true;
-    }
-    return false;
+// Function to write one token in the tokens.txt format
+void writeTokenText(ostream& out, const Token& token, string_view lexeme) {
+    out << "Lexeme: " << lexeme << ", Token: " << tokenKindName(token.kind) << '\n';
 }
 
-// Function to check if a character is an operator
-bool isOperator(char ch) {
-    return (ch == '+' || ch == '-' || ch == '*' || ch == '/' || ch == '=' ||
-            ch == '<' || ch == '>' || ch == '!' || ch == '%');
+void printUsage(const char* program) {
+    cout << "Usage: " << program << " [input.txt | -] [-o tokens.txt] [-n] [-b tokens.bin] [-k keywords.txt] [-j threads] [-e max-errors]\n"
+         << "  -o FILE  write tokens as text to FILE (default tokens.txt)\n"
+         << "  -n       do not write the text token file\n"
+         << "  -b FILE  also write tokens to FILE in the binary token format\n"
+         << "  -k FILE  read reserved words from FILE instead of the built-in list\n"
+         << "  -j N     lex a file on N threads (0 = all cores); stdin is always lexed on one\n"
+         << "  -e N     print at most N lexical errors (default " << ERROR_LOG_DEFAULT_LIMIT << "), then a count\n";
 }
 
-// Function to check if a character is a symbol (parentheses, brackets, etc.)
-bool isSymbol(char ch) {
-    return (ch == '(' || ch == ')' || ch == '{' || ch == '}');
-}
+int main(int argc, char* argv[]) {
+    const char* inputName = "input.txt";  // "-" reads stdin
+    const char* tokenName = "tokens.txt";
+    const char* keywordName = nullptr;
+    const char* binaryName = nullptr;
+    bool writeText = true;
+    unsigned threads = 1;
+    size_t maxErrors = ERROR_LOG_DEFAULT_LIMIT;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            tokenName = argv[++i];
+        } else if (strcmp(argv[i], "-n") == 0) {
+            writeText = false;
+        } else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            binaryName = argv[++i];
+        } else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) {
+            keywordName = argv[++i];
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            threads = (unsigned)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) {
+            maxErrors = (size_t)atol(argv[++i]);
+        } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            printUsage(argv[0]);
+            return 1;
+        } else {
+            inputName = argv[i];
+        }
+    }
 
-int main() {
-    ifstream inputFile("input.txt");
-    ofstream tokenFile("tokens.txt");
+    KeywordSet keywords = defaultKeywords;  // Reserved words, optionally replaced from a file
+    if (keywordName && !keywords.loadFile(keywordName)) {
+        cout << "Error loading keywords from " << keywordName << endl;
+        return 1;
+    }
 
-    if (!inputFile.is_open() || !tokenFile.is_open()) {
+    InputBuffer input;
+    ofstream tokenFile;
+    TokenFileWriter binaryFile;
+    if (writeText) tokenFile.open(tokenName);
+    if (!input.open(inputName) || (writeText && !tokenFile.is_open()) ||
+        (binaryName && !binaryFile.open(binaryName))) {
         cout << "Error opening file!" << endl;
         return 1;
     }
 
-    // Read entire file into input tape
-    inputFile.read(inputTape, MAX_TAPE_SIZE);
-    int tapeLength = inputFile.gcount();
-    inputFile.close();
-
-    while (end_point < tapeLength) {
-        // Skip spaces, tabs, and new lines
-        while (isspace(inputTape[end_point])) {
-            end_point++;
+    ErrorLog errors(maxErrors);
+    auto consume = [&](const Token& token, string_view lexeme) {
+        if (binaryName) binaryFile.add(token, lexeme);
+        if (token.kind == TokenKind::Error) {
+            errors.add(token, lexeme[0]);
+        } else if (writeText) {
+            writeTokenText(tokenFile, token, lexeme);
         }
-
-        start_point = end_point;  // Set start of lexeme
-
-        // Identifiers & Keywords
-        if (isalpha(inputTape[end_point]) || inputTape[end_point] == '_') {
-            while (isalnum(inputTape[end_point]) || inputTape[end_point] == '_') {
-                end_point++;
-            }
-            string lexeme(inputTape + start_point, inputTape + end_point);
-            if (isKeyword(lexeme)) {
-                tokenFile << "Lexeme: " << lexeme << ", Token: Reserved Word\n";
-            } else {
-                tokenFile << "Lexeme: " << lexeme << ", Token: Identifier\n";
+    };
+
+    if (threads != 1 && input.isMapped()) {
+        // The whole file is in memory: lex chunks in parallel, consume them in order
+        vector<LexChunk> chunks = lexChunks(input.data(), input.size(), keywords, threads);
+        for (auto& chunk : chunks) {
+            for (const Token& token : chunk.tokens) {
+                consume(token, string_view(input.data() + token.offset, token.length));
             }
+            vector<Token>().swap(chunk.tokens);
         }
-        // Numbers (Integer & Float)
-        else if (isdigit(inputTape[end_point])) {
-            bool isFloat = false;
-            while (isdigit(inputTape[end_point]) || inputTape[end_point] == '.') {
-                if (inputTape[end_point] == '.') {
-                    if (isFloat) break; // Prevent multiple dots
-                    isFloat = true;
-                }
-                end_point++;
-            }
-            string lexeme(inputTape + start_point, inputTape + end_point);
-            tokenFile << "Lexeme: " << lexeme << ", Token: " << (isFloat ? "Float Number\n" : "Integer\n");
-        }
-        // Operators
-        else if (isOperator(inputTape[end_point])) {
-            char first = inputTape[end_point];
-            char second = inputTape[end_point + 1];
-
-            if ((first == '=' && second == '=') || (first == '!' && second == '=') ||
-                (first == '<' && second == '=') || (first == '>' && second == '=')) {
-                tokenFile << "Lexeme: " << first << second << ", Token: Operator\n";
-                end_point += 2;
-            } else {
-                tokenFile << "Lexeme: " << first << ", Token: Operator\n";
-                end_point++;
-            }
-        }
-        // Statement Terminator `#`
-        else if (inputTape[end_point] == '#') {
-            tokenFile << "Lexeme: #, Token: Statement Terminator\n";
-            end_point++;
-        }
-        // Parentheses & Block Symbols
-        else if (isSymbol(inputTape[end_point])) {
-            tokenFile << "Lexeme: " << inputTape[end_point] << ", Token: Symbol\n";
-            end_point++;
-        }
-        // Unknown Symbols (Now Fixed)
-        else {
-            if (isprint(inputTape[end_point])) {
-                cout << "Lexical Error: Unknown Symbol -> " << inputTape[end_point] << endl;
-            } else {
-                cout << "Lexical Error: Unknown Non-Printable Character Detected" << endl;
-            }
-            end_point++;
+    } else {
+        Lexer lexer(input, keywords);
+        for (Token token = lexer.next(); token.kind != TokenKind::End; token = lexer.next()) {
+            consume(token, lexer.text(token));
         }
     }
 
-    cout << "Lexical analysis complete. Tokens stored in tokens.txt\n";
+    errors.flush(stdout);
+
+    if (binaryName && !binaryFile.close()) {
+        cout << "Error writing " << binaryName << endl;
+        return 1;
+    }
 
-    tokenFile.close();
+    if (writeText) {
+        cout << "Lexical analysis complete. Tokens stored in " << tokenName << "\n";
+        tokenFile.close();
+    } else {
+        cout << "Lexical analysis complete.\n";
+    }
     return 0;
 }
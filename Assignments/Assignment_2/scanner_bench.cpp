@@ -0,0 +1,306 @@
+#include <iostream>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include "bench_support.h"
+#include "lexer.h"
+#include "parallel_lexer.h"
+#include "token_file.h"
+
+using namespace std;
+
+// Lexer regression benchmark. Generates a synthetic program for each token
+// mix and runs every lexer mode over it, reporting MB/s, tokens/s and heap
+// allocations per token. The modes are:
+//   if/else scanner       the scanning loop from before the DFA
+//   Lexer, <set> runs     the Lexer with each run kernel set the CPU
+//                         supports (scalar, sse2, avx2)
+//   Lexer, mmap file      the Lexer over the program read back memory-mapped
+//   Lexer, stream file    the same file through the refill buffer that pipes
+//                         and stdin use
+//   Lexer, parallel       the chunked Lexer on every hardware thread
+//   Lexer, binary writer  the Lexer feeding the binary token file writer
+// Every mode must report the same number of tokens of each kind as the
+// if/else scanner, or the exit status is non-zero.
+// Build: g++ -O2 -std=c++17 -pthread scanner_bench.cpp -o scanner_bench
+// Usage: ./scanner_bench [megabytes] [mixed|identifiers|numbers|operators|errors|all]
+
+string keywords[] = {"int", "float", "string", "if", "else", "while", "return"};
+int numKeywords = sizeof(keywords) / sizeof(keywords[0]);
+
+bool isKeyword(string lexeme) {
+    for (int i = 0; i < numKeywords; i++) {
+        if (lexeme == keywords[i]) return true;
+    }
+    return false;
+}
+
+bool isOperator(char ch) {
+    return (ch == '+' || ch == '-' || ch == '*' || ch == '/' || ch == '=' ||
+            ch == '<' || ch == '>' || ch == '!' || ch == '%');
+}
+
+bool isSymbol(char ch) {
+    return (ch == '(' || ch == ')' || ch == '{' || ch == '}');
+}
+
+// Token groups the corpus generator draws from
+enum PieceGroup { WORDS, NUMBERS, OPERATORS, ERRORS, NUM_GROUPS };
+
+static const vector<const char*> groupPieces[NUM_GROUPS] = {
+    {"int", "float", "string", "if", "else", "while", "return",
+     "x", "count", "total_sum", "_tmp1", "value2", "averageTemperatureReading"},
+    {"0", "42", "1000", "3.14", "0.5", "65536", "2.718281828", "7."},
+    {"=", "==", "!=", "<=", ">=", "<", ">", "+", "-", "*", "/", "%",
+     "#", "(", ")", "{", "}"},
+    {"@", "$", "?", "~", "`", "&", "|", "\x01", "\x7f"}
+};
+
+// A token mix, as percentages of pieces drawn from each group
+struct CorpusMix {
+    const char* name;
+    unsigned weight[NUM_GROUPS];
+};
+
+static const CorpusMix corpusMixes[] = {
+    {"mixed", {45, 20, 33, 2}},
+    {"identifiers", {85, 5, 10, 0}},
+    {"numbers", {10, 80, 10, 0}},
+    {"operators", {10, 5, 85, 0}},
+    {"errors", {30, 10, 20, 40}},
+};
+
+// Function to generate a synthetic program of roughly `size` bytes with the given mix
+string generateInput(size_t size, const CorpusMix& mix) {
+    static const char* separators[] = {" ", " ", " ", "\n", "\n    ", "\t", ""};
+    mt19937 rng(12345);
+    string text;
+    text.reserve(size + 64);
+    while (text.size() < size) {
+        unsigned pick = rng() % 100, group = 0;
+        while (group + 1 < NUM_GROUPS && pick >= mix.weight[group]) pick -= mix.weight[group++];
+        const vector<const char*>& pieces = groupPieces[group];
+        text += pieces[rng() % pieces.size()];
+        text += separators[rng() % (sizeof(separators) / sizeof(separators[0]))];
+    }
+    return text;
+}
+
+// The scanning loop as it was before the DFA, minus the file output
+size_t scanLegacy(const char* inputTape, size_t tapeLength, size_t counts[]) {
+    size_t tokens = 0;
+    size_t end_point = 0, start_point = 0;
+    while (end_point < tapeLength) {
+        while (isspace(inputTape[end_point])) end_point++;
+        start_point = end_point;
+        if (end_point >= tapeLength) break;
+
+        if (isalpha(inputTape[end_point]) || inputTape[end_point] == '_') {
+            while (isalnum(inputTape[end_point]) || inputTape[end_point] == '_') end_point++;
+            string lexeme(inputTape + start_point, inputTape + end_point);
+            counts[isKeyword(lexeme) ? (int)TokenKind::ReservedWord : (int)TokenKind::Identifier]++;
+        } else if (isdigit(inputTape[end_point])) {
+            bool isFloat = false;
+            while (isdigit(inputTape[end_point]) || inputTape[end_point] == '.') {
+                if (inputTape[end_point] == '.') {
+                    if (isFloat) break;
+                    isFloat = true;
+                }
+                end_point++;
+            }
+            string lexeme(inputTape + start_point, inputTape + end_point);
+            counts[isFloat ? (int)TokenKind::Float : (int)TokenKind::Integer]++;
+        } else if (isOperator(inputTape[end_point])) {
+            char first = inputTape[end_point];
+            char second = inputTape[end_point + 1];
+            if ((first == '=' && second == '=') || (first == '!' && second == '=') ||
+                (first == '<' && second == '=') || (first == '>' && second == '=')) {
+                end_point += 2;
+            } else {
+                end_point++;
+            }
+            counts[(int)TokenKind::Operator]++;
+        } else if (inputTape[end_point] == '#') {
+            counts[(int)TokenKind::StatementTerminator]++;
+            end_point++;
+        } else if (isSymbol(inputTape[end_point])) {
+            counts[(int)TokenKind::Symbol]++;
+            end_point++;
+        } else {
+            counts[(int)TokenKind::Error]++;
+            end_point++;
+        }
+        tokens++;
+    }
+    return tokens;
+}
+
+// The Lexer API used by scanner.cpp, with the given run kernels
+size_t scanLexer(const char* inputTape, size_t tapeLength, size_t counts[], const ScanKernels& kernels) {
+    size_t tokens = 0;
+    Lexer lexer(inputTape, tapeLength);
+    lexer.setKernels(kernels);
+    for (Token token = lexer.next(); token.kind != TokenKind::End; token = lexer.next()) {
+        counts[(int)token.kind]++;
+        tokens++;
+    }
+    return tokens;
+}
+
+// Temporary copy of the corpus for the file modes
+static const char* inputPath = "scanner_bench.input.txt";
+
+// Function to lex an opened InputBuffer as scanner.cpp does on one thread
+size_t scanInput(InputBuffer& input, size_t counts[]) {
+    size_t tokens = 0;
+    Lexer lexer(input);
+    for (Token token = lexer.next(); token.kind != TokenKind::End; token = lexer.next()) {
+        counts[(int)token.kind]++;
+        tokens++;
+    }
+    return tokens;
+}
+
+// The Lexer over the memory-mapped input file
+size_t scanMappedFile(const char*, size_t, size_t counts[]) {
+    InputBuffer input;
+    if (!input.open(inputPath)) return 0;
+    return scanInput(input, counts);
+}
+
+// The Lexer over the input file read through the two-half refill buffer
+size_t scanStreamFile(const char*, size_t, size_t counts[]) {
+    InputBuffer input;
+    if (!input.openStream(inputPath)) return 0;
+    return scanInput(input, counts);
+}
+
+// The parallel chunked Lexer on every hardware thread
+size_t scanParallel(const char* inputTape, size_t tapeLength, size_t counts[]) {
+    size_t tokens = 0;
+    vector<LexChunk> chunks = lexChunks(inputTape, tapeLength, defaultKeywords, 0);
+    for (const LexChunk& chunk : chunks) {
+        for (const Token& token : chunk.tokens) counts[(int)token.kind]++;
+        tokens += chunk.tokens.size();
+    }
+    return tokens;
+}
+
+// The Lexer feeding the binary token file writer, as `scanner -b` does
+size_t scanBinaryWriter(const char* inputTape, size_t tapeLength, size_t counts[]) {
+    static const char* path = "scanner_bench.tokens.bin";
+    size_t tokens = 0;
+    TokenFileWriter writer;
+    if (!writer.open(path)) {
+        cout << "Cannot create " << path << endl;
+        return 0;
+    }
+    Lexer lexer(inputTape, tapeLength);
+    for (Token token = lexer.next(); token.kind != TokenKind::End; token = lexer.next()) {
+        writer.add(token, lexer.text(token));
+        counts[(int)token.kind]++;
+        tokens++;
+    }
+    writer.close();
+    remove(path);
+    return tokens;
+}
+
+#define KIND_COUNT ((int)TokenKind::Error + 1)
+
+struct Result {
+    string name;
+    size_t tokens;
+    double mbps;
+    size_t counts[KIND_COUNT]; // Tokens of each kind
+};
+
+template <typename Scan>
+Result measure(const char* name, Scan scan, const string& text) {
+    Result result = {};
+    size_t* counts = result.counts;
+    RunCost cost;
+    size_t tokens = measureRun([&]() { return scan(text.data(), text.size(), counts); }, cost);
+
+    double mbps = text.size() / cost.seconds / 1e6;
+    char line[160];
+    snprintf(line, sizeof(line), "  %-20s %12zu tokens %9.1f MB/s %9.2f Mtokens/s %9.4f allocs/token\n", name,
+             tokens, mbps, tokens / cost.seconds / 1e6, tokens ? (double)cost.allocations / tokens : 0.0);
+    cout << line;
+    result.name = name;
+    result.tokens = tokens;
+    result.mbps = mbps;
+    return result;
+}
+
+// Function to compare a mode's per-kind counts with the if/else scanner's; prints each difference
+bool sameCounts(const Result& result, const Result& legacy) {
+    bool same = true;
+    for (int kind = 0; kind < KIND_COUNT; kind++) {
+        if (result.counts[kind] == legacy.counts[kind]) continue;
+        cout << "  " << result.name << ": " << result.counts[kind] << " " << tokenKindName((TokenKind)kind)
+             << " tokens, if/else scanner " << legacy.counts[kind] << endl;
+        same = false;
+    }
+    return same;
+}
+
+// Function to run every lexer mode over one corpus; false if any disagrees on the tokens of some kind
+bool runMix(const CorpusMix& mix, size_t megabytes) {
+    string text = generateInput(megabytes * 1000000, mix);
+    cout << mix.name << " (" << text.size() / 1e6 << " MB)\n";
+
+    Result legacy = measure("if/else scanner", scanLegacy, text);
+    // One row per run kernel set the CPU supports
+    vector<Result> results;
+    const ScanKernels* sets[3];
+    size_t kernelCount = supportedScanKernels(sets);
+    for (size_t k = 0; k < kernelCount; k++) {
+        string name = string("Lexer, ") + sets[k]->name + " runs";
+        auto scan = [&](const char* inputTape, size_t tapeLength, size_t counts[]) {
+            return scanLexer(inputTape, tapeLength, counts, *sets[k]);
+        };
+        results.push_back(measure(name.c_str(), scan, text));
+    }
+    ofstream inputFile(inputPath, ios::binary);
+    inputFile << text;
+    inputFile.close();
+    if (inputFile) {
+        results.push_back(measure("Lexer, mmap file", scanMappedFile, text));
+        results.push_back(measure("Lexer, stream file", scanStreamFile, text));
+    } else {
+        cout << "Cannot write " << inputPath << "; skipping the file modes" << endl;
+    }
+    remove(inputPath);
+    results.push_back(measure("Lexer, parallel", scanParallel, text));
+    results.push_back(measure("Lexer, binary writer", scanBinaryWriter, text));
+
+    bool agree = true;
+    for (const Result& result : results) agree = sameCounts(result, legacy) && agree;
+    if (!agree) cout << "Token counts differ!" << endl;
+    size_t picked = 0; // The row of the set the Lexer uses by default
+    while (sets[picked] != &scanKernels()) picked++;
+    cout << "  Speedup over if/else: " << results[picked].mbps / legacy.mbps << "x\n";
+    return agree;
+}
+
+int main(int argc, char* argv[]) {
+    size_t megabytes = argc > 1 ? stoul(argv[1]) : 64;
+    string mixName = argc > 2 ? argv[2] : "all";
+
+    bool ok = true, found = false;
+    for (const CorpusMix& mix : corpusMixes) {
+        if (mixName != "all" && mixName != mix.name) continue;
+        found = true;
+        ok = runMix(mix, megabytes) && ok;
+    }
+    if (!found) {
+        cout << "Unknown mix " << mixName << "; use mixed, identifiers, numbers, operators, errors or all" << endl;
+        return 1;
+    }
+    return ok ? 0 : 1;
+}
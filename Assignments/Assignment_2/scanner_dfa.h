@@ -0,0 +1,169 @@
+#ifndef SCANNER_DFA_H
+#define SCANNER_DFA_H
+
+#include <cstdint>
+
+// Transition-table form of the automaton in DFA.png.
+//
+// Every input byte is first mapped to a character class through a 256-entry
+// table, then the dense state x class table gives the next state. States from
+// DFA_FINAL upwards end the lexeme, so the scanning loop is one lookup per
+// byte with no tests on the character itself.
+
+// Kinds of lexemes the scanner reports
+enum class TokenKind : uint8_t {
+    End,
+    Identifier,
+    ReservedWord,
+    Integer,
+    Float,
+    Operator,
+    StatementTerminator,
+    Symbol,
+    Error
+};
+
+// Character classes
+enum CharClass : uint8_t {
+    C_OTHER,     // Anything the language does not use (also the '\0' sentinel)
+    C_SPACE,     // ' ', \t, \n, \v, \f, \r
+    C_LETTER,    // a-z, A-Z, _
+    C_DIGIT,     // 0-9
+    C_DOT,       // .
+    C_ARITH,     // + - * / %
+    C_EQUAL,     // =
+    C_RELATION,  // < > !
+    C_HASH,      // # (statement terminator)
+    C_SYMBOL,    // ( ) { }
+    NUM_CLASSES
+};
+
+// DFA states; qN names refer to the states in DFA.png
+enum DfaState : uint8_t {
+    Q_START,     // q0
+    Q_IDENT,     // q1
+    Q_INTEGER,   // q3
+    Q_FLOAT,     // q3 after the decimal point
+    Q_RELATION,  // q5: '=', '<', '>' or '!' that may be followed by '='
+
+    // Accepting states entered on the first byte after the lexeme
+    DFA_FINAL,
+    F_IDENT = DFA_FINAL,  // q2
+    F_INTEGER,            // q4
+    F_FLOAT,
+    F_RELATION,           // Single-character '=', '<', '>' or '!'
+
+    // Accepting states entered on the last byte of the lexeme
+    DFA_INCLUSIVE,
+    F_ARITH = DFA_INCLUSIVE,  // q6
+    F_RELATION_EQ,            // ==, !=, <=, >=
+    F_TERMINATOR,             // q8
+    F_SYMBOL,                 // q7
+    F_ERROR,                  // Byte outside the language
+    NUM_STATES
+};
+
+struct ScannerDfa {
+    uint8_t classOf[256];
+    uint8_t next[DFA_FINAL][NUM_CLASSES];
+    TokenKind kindOf[NUM_STATES];
+};
+
+// Function to build the tables from the transitions of the diagram
+constexpr ScannerDfa buildScannerDfa() {
+    ScannerDfa dfa = {};
+
+    for (int ch = 0; ch < 256; ch++) dfa.classOf[ch] = C_OTHER;
+    for (char ch : {' ', '\t', '\n', '\v', '\f', '\r'}) dfa.classOf[(unsigned char)ch] = C_SPACE;
+    for (int ch = 'a'; ch <= 'z'; ch++) dfa.classOf[ch] = C_LETTER;
+    for (int ch = 'A'; ch <= 'Z'; ch++) dfa.classOf[ch] = C_LETTER;
+    dfa.classOf['_'] = C_LETTER;
+    for (int ch = '0'; ch <= '9'; ch++) dfa.classOf[ch] = C_DIGIT;
+    dfa.classOf['.'] = C_DOT;
+    for (char ch : {'+', '-', '*', '/', '%'}) dfa.classOf[(unsigned char)ch] = C_ARITH;
+    dfa.classOf['='] = C_EQUAL;
+    for (char ch : {'<', '>', '!'}) dfa.classOf[(unsigned char)ch] = C_RELATION;
+    dfa.classOf['#'] = C_HASH;
+    for (char ch : {'(', ')', '{', '}'}) dfa.classOf[(unsigned char)ch] = C_SYMBOL;
+
+    // q0: the first byte decides the kind of lexeme
+    for (int c = 0; c < NUM_CLASSES; c++) dfa.next[Q_START][c] = F_ERROR;
+    dfa.next[Q_START][C_LETTER] = Q_IDENT;
+    dfa.next[Q_START][C_DIGIT] = Q_INTEGER;
+    dfa.next[Q_START][C_ARITH] = F_ARITH;
+    dfa.next[Q_START][C_EQUAL] = Q_RELATION;
+    dfa.next[Q_START][C_RELATION] = Q_RELATION;
+    dfa.next[Q_START][C_HASH] = F_TERMINATOR;
+    dfa.next[Q_START][C_SYMBOL] = F_SYMBOL;
+
+    // q1: letters, digits and '_' continue an identifier
+    for (int c = 0; c < NUM_CLASSES; c++) dfa.next[Q_IDENT][c] = F_IDENT;
+    dfa.next[Q_IDENT][C_LETTER] = Q_IDENT;
+    dfa.next[Q_IDENT][C_DIGIT] = Q_IDENT;
+
+    // q3: digits, with at most one '.' turning the number into a float
+    for (int c = 0; c < NUM_CLASSES; c++) dfa.next[Q_INTEGER][c] = F_INTEGER;
+    dfa.next[Q_INTEGER][C_DIGIT] = Q_INTEGER;
+    dfa.next[Q_INTEGER][C_DOT] = Q_FLOAT;
+    for (int c = 0; c < NUM_CLASSES; c++) dfa.next[Q_FLOAT][c] = F_FLOAT;
+    dfa.next[Q_FLOAT][C_DIGIT] = Q_FLOAT;
+
+    // q5: a following '=' makes a two-character operator
+    for (int c = 0; c < NUM_CLASSES; c++) dfa.next[Q_RELATION][c] = F_RELATION;
+    dfa.next[Q_RELATION][C_EQUAL] = F_RELATION_EQ;
+
+    dfa.kindOf[F_IDENT] = TokenKind::Identifier;
+    dfa.kindOf[F_INTEGER] = TokenKind::Integer;
+    dfa.kindOf[F_FLOAT] = TokenKind::Float;
+    dfa.kindOf[F_RELATION] = TokenKind::Operator;
+    dfa.kindOf[F_ARITH] = TokenKind::Operator;
+    dfa.kindOf[F_RELATION_EQ] = TokenKind::Operator;
+    dfa.kindOf[F_TERMINATOR] = TokenKind::StatementTerminator;
+    dfa.kindOf[F_SYMBOL] = TokenKind::Symbol;
+    dfa.kindOf[F_ERROR] = TokenKind::Error;
+    return dfa;
+}
+
+inline constexpr ScannerDfa scannerDfa = buildScannerDfa();
+
+// Function to run the DFA from p, which must not be at a space.
+// Returns the end of the lexeme and stores the accepting state in `state`.
+inline const char* runScannerDfa(const char* p, unsigned& state) {
+    unsigned s = Q_START;
+    do {
+        s = scannerDfa.next[s][scannerDfa.classOf[(unsigned char)*p++]];
+    } while (s < DFA_FINAL);
+    state = s;
+    return p - (s < DFA_INCLUSIVE);
+}
+
+// Scalar run loops for the scanner's hottest paths; scanner_simd.h has the
+// vector versions, which fall back to these for the last partial block. Each
+// stops at the latest on the '\0' sentinel behind the input.
+
+// Function to find the first byte at or after p that is not a space; counts
+// the newlines skipped and points lastNewline at the last of them
+inline const char* skipSpaces(const char* p, uint32_t& newlines, const char*& lastNewline) {
+    while (scannerDfa.classOf[(unsigned char)*p] == C_SPACE) {
+        if (*p == '\n') {
+            newlines++;
+            lastNewline = p;
+        }
+        p++;
+    }
+    return p;
+}
+
+// Function to find the first byte at or after p that is not a letter, digit or '_'
+inline const char* identifierEnd(const char* p) {
+    while (scannerDfa.classOf[(unsigned char)*p] == C_LETTER || scannerDfa.classOf[(unsigned char)*p] == C_DIGIT) p++;
+    return p;
+}
+
+// Function to find the first byte at or after p that is not a digit
+inline const char* digitsEnd(const char* p) {
+    while (scannerDfa.classOf[(unsigned char)*p] == C_DIGIT) p++;
+    return p;
+}
+
+#endif
@@ -0,0 +1,103 @@
+#include <iostream>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "lexer.h"
+
+using namespace std;
+
+// Randomized check of the SSE2/AVX2 run kernels against the scalar loops.
+// Every text sits in a heap block of exactly its length plus the '\0'
+// sentinel, so under -fsanitize=address any load past the sentinel is
+// reported. For every start position each kernel must return the same end,
+// newline count and last newline as the scalar loop, and a Lexer using the
+// kernels must produce the same tokens as one using the scalar loops.
+// Build: g++ -O2 -std=c++17 scanner_kernels_check.cpp -o scanner_kernels_check
+// Usage: ./scanner_kernels_check [texts] [seed]
+
+// Runs of one class, so texts hold runs longer than a vector block
+static const char* runs[] = {" ", "    ", "\t\t", "\n", "\n        ", "\r\n", " \v\f ",
+                             "x", "count_1", "_tmp", "averageTemperatureReadingForTheWholeYear", "ABCxyz_09",
+                             "7", "42", "1234567890123456789012345678901234567890", "3.14",
+                             "=", "==", "#", "(", "@", "`", "{", "[", "/", "\x80", "\xc1", "\xff", "\x01"};
+static const size_t numRuns = sizeof(runs) / sizeof(runs[0]);
+
+// Function to make a random text of about `size` bytes
+string randomText(mt19937& rng, size_t size) {
+    string text;
+    while (text.size() < size) text += runs[rng() % numRuns];
+    text.resize(size);
+    return text;
+}
+
+vector<Token> lexAll(const char* data, size_t size, const ScanKernels& kernels) {
+    vector<Token> tokens;
+    Lexer lexer(data, size);
+    lexer.setKernels(kernels);
+    for (Token token = lexer.next(); token.kind != TokenKind::End; token = lexer.next()) tokens.push_back(token);
+    return tokens;
+}
+
+bool sameTokens(const vector<Token>& a, const vector<Token>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].kind != b[i].kind || a[i].offset != b[i].offset || a[i].length != b[i].length ||
+            a[i].line != b[i].line || a[i].col != b[i].col) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Function to compare one kernel set with the scalar loops at every position of one text
+bool checkText(const ScanKernels& kernels, const string& text, size_t number) {
+    size_t size = text.size();
+    unique_ptr<char[]> block(new char[size + 1]);
+    memcpy(block.get(), text.data(), size);
+    block[size] = '\0';
+    const char* data = block.get();
+    const char* end = data + size;
+
+    for (size_t at = 0; at <= size; at++) {
+        const char* p = data + at;
+        uint32_t wantLines = 0, gotLines = 0;
+        const char *wantLast = nullptr, *gotLast = nullptr;
+        const char* want = skipSpaces(p, wantLines, wantLast);
+        const char* got = kernels.skipSpaces(p, end, gotLines, gotLast);
+        const char* which = nullptr;
+        if (got != want || gotLines != wantLines || gotLast != wantLast) which = "skipSpaces";
+        else if (kernels.identifierEnd(p, end) != identifierEnd(p)) which = "identifierEnd";
+        else if (kernels.digitsEnd(p, end) != digitsEnd(p)) which = "digitsEnd";
+        if (!which) continue;
+        cout << kernels.name << " " << which << " differs from scalar on text " << number << " (" << size
+             << " bytes) at offset " << at << endl;
+        return false;
+    }
+    if (!sameTokens(lexAll(data, size, kernels), lexAll(data, size, scalarKernels))) {
+        cout << "Lexer with " << kernels.name << " kernels differs from scalar on text " << number << endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    size_t texts = argc > 1 ? stoul(argv[1]) : 2000;
+    mt19937 rng(argc > 2 ? stoul(argv[2]) : 12345);
+
+    const ScanKernels* sets[3];
+    size_t count = supportedScanKernels(sets);
+    for (size_t t = 0; t < texts; t++) {
+        string text = randomText(rng, rng() % 300);
+        for (size_t k = 1; k < count; k++) {
+            if (!checkText(*sets[k], text, t)) return 1;
+        }
+    }
+
+    cout << texts << " texts match the scalar loops with kernels:";
+    for (size_t k = 1; k < count; k++) cout << " " << sets[k]->name;
+    if (count == 1) cout << " (none besides scalar on this CPU)";
+    cout << endl;
+    return 0;
+}
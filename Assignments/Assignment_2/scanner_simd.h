@@ -0,0 +1,170 @@
+#ifndef SCANNER_SIMD_H
+#define SCANNER_SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+#include "scanner_dfa.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SCANNER_X86 1
+#endif
+
+// SSE2 and AVX2 versions of the run loops in scanner_dfa.h: skipping
+// whitespace and finding the end of an identifier or digit run. Each step
+// classifies 16 or 32 bytes and finds the first byte outside the run with
+// movemask + count-trailing-zeros. The CPU is probed once; the Lexer uses
+// SSE2 where it is available and the scalar loops elsewhere. AVX2 is there
+// for setKernels: tokens in this language are short, so a run usually ends
+// inside the first block and the wider step measures no faster than scalar.
+//
+// Every kernel takes `end`, the position of the sentinel behind the input.
+// Blocks are loaded unaligned and only while a whole block lies before end,
+// so no load touches a byte at or past it. The last partial block is left to
+// the scalar loop, which stops on the sentinel as before, so every kernel
+// returns exactly what the scalar loop returns.
+
+struct ScanKernels {
+    // First byte at or after p that is not a space; counts the newlines skipped
+    // and points lastNewline at the last of them
+    const char* (*skipSpaces)(const char* p, const char* end, uint32_t& newlines, const char*& lastNewline);
+    // First byte at or after p that is not a letter, digit or '_'
+    const char* (*identifierEnd)(const char* p, const char* end);
+    // First byte at or after p that is not a digit
+    const char* (*digitsEnd)(const char* p, const char* end);
+    const char* name;
+};
+
+inline const char* skipSpacesScalar(const char* p, const char*, uint32_t& newlines, const char*& lastNewline) {
+    return skipSpaces(p, newlines, lastNewline);
+}
+
+inline const char* identifierEndScalar(const char* p, const char*) { return identifierEnd(p); }
+
+inline const char* digitsEndScalar(const char* p, const char*) { return digitsEnd(p); }
+
+#ifdef SCANNER_X86
+
+// Byte-wise "lo <= x <= lo + span" using wrap-around subtract and saturating subtract
+inline __m128i inRange128(__m128i x, char lo, char span) {
+    __m128i shifted = _mm_subs_epu8(_mm_sub_epi8(x, _mm_set1_epi8(lo)), _mm_set1_epi8(span));
+    return _mm_cmpeq_epi8(shifted, _mm_setzero_si128());
+}
+
+// ' ' and \t \n \v \f \r, the C_SPACE class
+inline __m128i spaceMask128(__m128i x) {
+    return _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(' ')), inRange128(x, '\t', '\r' - '\t'));
+}
+
+// Letters, digits and '_'; setting bit 5 folds A-Z onto a-z and maps no other byte there
+inline __m128i identifierMask128(__m128i x) {
+    __m128i letter = inRange128(_mm_or_si128(x, _mm_set1_epi8(0x20)), 'a', 'z' - 'a');
+    __m128i digit = inRange128(x, '0', 9);
+    return _mm_or_si128(_mm_or_si128(letter, digit), _mm_cmpeq_epi8(x, _mm_set1_epi8('_')));
+}
+
+inline __m128i digitMask128(__m128i x) { return inRange128(x, '0', 9); }
+
+// Function to walk 16-byte blocks until a byte outside the class shows up,
+// handing the last partial block to the scalar loop
+template <__m128i (*InClass)(__m128i), const char* (*Tail)(const char*)>
+const char* runEndSse2(const char* p, const char* end) {
+    for (; end - p >= 16; p += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)p);
+        uint32_t outside = ~(uint32_t)_mm_movemask_epi8(InClass(x)) & 0xFFFFu;
+        if (outside) return p + __builtin_ctz(outside);
+    }
+    return Tail(p);
+}
+
+inline const char* skipSpacesSse2(const char* p, const char* end, uint32_t& newlines, const char*& lastNewline) {
+    for (; end - p >= 16; p += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)p);
+        uint32_t outside = ~(uint32_t)_mm_movemask_epi8(spaceMask128(x)) & 0xFFFFu;
+        uint32_t lines = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_set1_epi8('\n')));
+        if (outside) lines &= (outside & -outside) - 1;  // Only newlines before the run ends
+        if (lines) {
+            newlines += __builtin_popcount(lines);
+            lastNewline = p + 31 - __builtin_clz(lines);
+        }
+        if (outside) return p + __builtin_ctz(outside);
+    }
+    return skipSpaces(p, newlines, lastNewline);
+}
+
+__attribute__((target("avx2"))) inline __m256i inRange256(__m256i x, char lo, char span) {
+    __m256i shifted = _mm256_subs_epu8(_mm256_sub_epi8(x, _mm256_set1_epi8(lo)), _mm256_set1_epi8(span));
+    return _mm256_cmpeq_epi8(shifted, _mm256_setzero_si256());
+}
+
+__attribute__((target("avx2"))) inline __m256i spaceMask256(__m256i x) {
+    return _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8(' ')), inRange256(x, '\t', '\r' - '\t'));
+}
+
+__attribute__((target("avx2"))) inline __m256i identifierMask256(__m256i x) {
+    __m256i letter = inRange256(_mm256_or_si256(x, _mm256_set1_epi8(0x20)), 'a', 'z' - 'a');
+    __m256i digit = inRange256(x, '0', 9);
+    return _mm256_or_si256(_mm256_or_si256(letter, digit), _mm256_cmpeq_epi8(x, _mm256_set1_epi8('_')));
+}
+
+__attribute__((target("avx2"))) inline __m256i digitMask256(__m256i x) { return inRange256(x, '0', 9); }
+
+template <__m256i (*InClass)(__m256i), const char* (*Tail)(const char*)>
+__attribute__((target("avx2"))) const char* runEndAvx2(const char* p, const char* end) {
+    for (; end - p >= 32; p += 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)p);
+        uint32_t outside = ~(uint32_t)_mm256_movemask_epi8(InClass(x));
+        if (outside) return p + __builtin_ctz(outside);
+    }
+    return Tail(p);
+}
+
+__attribute__((target("avx2"))) inline const char* skipSpacesAvx2(const char* p, const char* end, uint32_t& newlines,
+                                                                   const char*& lastNewline) {
+    for (; end - p >= 32; p += 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)p);
+        uint32_t outside = ~(uint32_t)_mm256_movemask_epi8(spaceMask256(x));
+        uint32_t lines = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('\n')));
+        if (outside) lines &= (outside & -outside) - 1;  // Only newlines before the run ends
+        if (lines) {
+            newlines += __builtin_popcount(lines);
+            lastNewline = p + 31 - __builtin_clz(lines);
+        }
+        if (outside) return p + __builtin_ctz(outside);
+    }
+    return skipSpaces(p, newlines, lastNewline);
+}
+
+#endif
+
+inline constexpr ScanKernels scalarKernels = {skipSpacesScalar, identifierEndScalar, digitsEndScalar, "scalar"};
+
+#ifdef SCANNER_X86
+inline constexpr ScanKernels sse2Kernels = {skipSpacesSse2, runEndSse2<identifierMask128, identifierEnd>,
+                                            runEndSse2<digitMask128, digitsEnd>, "sse2"};
+inline constexpr ScanKernels avx2Kernels = {skipSpacesAvx2, runEndAvx2<identifierMask256, identifierEnd>,
+                                            runEndAvx2<digitMask256, digitsEnd>, "avx2"};
+#endif
+
+// Function to list the kernel sets this CPU can run, scalar first; returns how many
+inline size_t supportedScanKernels(const ScanKernels* sets[3]) {
+    size_t count = 0;
+    sets[count++] = &scalarKernels;
+#ifdef SCANNER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) sets[count++] = &sse2Kernels;
+    if (__builtin_cpu_supports("avx2")) sets[count++] = &avx2Kernels;
+#endif
+    return count;
+}
+
+// The kernel set the Lexer uses by default: SSE2 if the CPU has it, chosen on first call
+inline const ScanKernels& scanKernels() {
+    static const ScanKernels& kernels = []() -> const ScanKernels& {
+        const ScanKernels* sets[3];
+        return *sets[supportedScanKernels(sets) > 1 ? 1 : 0];
+    }();
+    return kernels;
+}
+
+#endif
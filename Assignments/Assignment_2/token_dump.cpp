@@ -0,0 +1,26 @@
+#include <iostream>
+#include "token_file.h"
+
+using namespace std;
+
+// Print a binary token file in the tokens.txt format.
+// Usage: ./token_dump tokens.bin
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cout << "Usage: " << argv[0] << " tokens.bin" << endl;
+        return 1;
+    }
+
+    TokenFileReader reader;
+    if (!reader.open(argv[1])) {
+        cout << "Error reading token file: " << argv[1] << endl;
+        return 1;
+    }
+
+    for (size_t i = 0; i < reader.size(); i++) {
+        if (reader.kind(i) == TokenKind::Error) continue;  // Errors are reported by the scanner
+        cout << "Lexeme: " << reader.text(i) << ", Token: " << tokenKindName(reader.kind(i)) << '\n';
+    }
+    return 0;
+}
@@ -0,0 +1,310 @@
+#ifndef TOKEN_FILE_H
+#define TOKEN_FILE_H
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+#include "lexer.h"
+
+// Binary token file: the compact alternative to tokens.txt.
+//
+//   TokenFileHeader
+//   TokenRecord records[tokenCount]          8 bytes per token
+//   uint64_t segmentFirst[segmentCount]      first token of each 4 GB stretch of input
+//   uint64_t lexemeIndex[lexemeCount + 1]    start of each lexeme in the pool
+//   uint8_t lexemeKinds[lexemeCount]         TokenKind of each lexeme (padded to 8 bytes)
+//   char lexemePool[poolSize]                every distinct lexeme once
+//
+// A lexeme always scans to the same kind, so kind and length live in the
+// interned lexeme table and a record only needs the lexeme id and the low 32
+// bits of the token offset; the high bits come from the segment table, which
+// has one entry per 4 GB of input. Records are collected in a large buffer and
+// written in big blocks; the reader maps the file and serves records in place.
+
+#define TOKEN_FILE_MAGIC 0x424B4F54u  // "TOKB"
+#define TOKEN_FILE_VERSION 1
+#define TOKEN_FILE_BUFFER (1 << 20)   // Bytes of records per write
+
+struct TokenFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t tokenCount;
+    uint64_t segmentCount;
+    uint64_t lexemeCount;
+    uint64_t poolSize;
+    uint64_t recordsOffset;
+    uint64_t segmentsOffset;
+    uint64_t lexemeIndexOffset;
+    uint64_t lexemeKindsOffset;
+    uint64_t lexemePoolOffset;
+};
+
+struct TokenRecord {
+    uint32_t lexeme;     // Index into the lexeme table
+    uint32_t offsetLow;  // Low 32 bits of the byte offset in the source
+};
+
+class TokenFileWriter {
+public:
+    ~TokenFileWriter() {
+        if (fd >= 0) ::close(fd);
+    }
+
+    bool open(const char* path) {
+        fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+        records.reserve(TOKEN_FILE_BUFFER / sizeof(TokenRecord));
+        lexemeIndex.push_back(0);
+        slots.assign(1024, EMPTY_SLOT);
+        // Reserve room for the header; it is filled in by close()
+        TokenFileHeader header = {};
+        return writeAll(&header, sizeof(header));
+    }
+
+    // Function to append one token with its lexeme
+    bool add(const Token& token, std::string_view lexeme) {
+        while ((token.offset >> 32) >= segmentFirst.size()) segmentFirst.push_back(tokenCount);
+
+        TokenRecord record;
+        record.lexeme = intern(lexeme, token.kind);
+        record.offsetLow = (uint32_t)token.offset;
+        records.push_back(record);
+        tokenCount++;
+        if (records.size() * sizeof(TokenRecord) >= TOKEN_FILE_BUFFER) return flushRecords();
+        return true;
+    }
+
+    // Function to write the segment and lexeme tables and the header, then close the file
+    bool close() {
+        if (fd < 0) return false;
+        bool ok = flushRecords();
+
+        size_t lexemeCount = kinds.size();
+        kinds.resize((lexemeCount + 7) / 8 * 8, 0);
+
+        TokenFileHeader header = {};
+        header.magic = TOKEN_FILE_MAGIC;
+        header.version = TOKEN_FILE_VERSION;
+        header.tokenCount = tokenCount;
+        header.segmentCount = segmentFirst.size();
+        header.lexemeCount = lexemeCount;
+        header.poolSize = pool.size();
+        header.recordsOffset = sizeof(TokenFileHeader);
+        header.segmentsOffset = header.recordsOffset + tokenCount * sizeof(TokenRecord);
+        header.lexemeIndexOffset = header.segmentsOffset + segmentFirst.size() * sizeof(uint64_t);
+        header.lexemeKindsOffset = header.lexemeIndexOffset + lexemeIndex.size() * sizeof(uint64_t);
+        header.lexemePoolOffset = header.lexemeKindsOffset + kinds.size();
+
+        ok = ok && writeAll(segmentFirst.data(), segmentFirst.size() * sizeof(uint64_t));
+        ok = ok && writeAll(lexemeIndex.data(), lexemeIndex.size() * sizeof(uint64_t));
+        ok = ok && writeAll(kinds.data(), kinds.size());
+        ok = ok && writeAll(pool.data(), pool.size());
+        ok = ok && pwrite(fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header);
+        ok = (::close(fd) == 0) && ok;
+        fd = -1;
+        return ok;
+    }
+
+private:
+    static constexpr uint32_t EMPTY_SLOT = UINT32_MAX;
+
+    int fd = -1;
+    uint64_t tokenCount = 0;
+    std::vector<TokenRecord> records;     // Pending records
+    std::vector<uint64_t> segmentFirst;   // First token of each 4 GB segment
+    std::vector<uint64_t> lexemeIndex;    // Start of each interned lexeme in pool
+    std::vector<uint8_t> kinds;           // TokenKind of each interned lexeme
+    std::vector<char> pool;               // Interned lexeme bytes
+    std::vector<uint32_t> slots;          // Open-addressing table of lexeme ids
+    std::vector<uint32_t> hashes;         // Hash of each interned lexeme
+
+    static uint32_t hashBytes(std::string_view s) {
+        uint32_t h = 2166136261u;
+        for (char ch : s) h = (h ^ (unsigned char)ch) * 16777619u;
+        return h;
+    }
+
+    std::string_view lexemeAt(uint32_t id) const {
+        return std::string_view(pool.data() + lexemeIndex[id], lexemeIndex[id + 1] - lexemeIndex[id]);
+    }
+
+    // Function to find or add a lexeme in the table
+    uint32_t intern(std::string_view lexeme, TokenKind kind) {
+        uint32_t h = hashBytes(lexeme);
+        size_t mask = slots.size() - 1;
+        for (size_t i = h & mask;; i = (i + 1) & mask) {
+            uint32_t id = slots[i];
+            if (id == EMPTY_SLOT) break;
+            if (hashes[id] == h && lexemeAt(id) == lexeme) return id;
+        }
+
+        uint32_t id = (uint32_t)hashes.size();
+        pool.insert(pool.end(), lexeme.begin(), lexeme.end());
+        lexemeIndex.push_back(pool.size());
+        kinds.push_back((uint8_t)kind);
+        hashes.push_back(h);
+        if (hashes.size() * 2 > slots.size()) {
+            rehash();
+        } else {
+            insertSlot(id);
+        }
+        return id;
+    }
+
+    void insertSlot(uint32_t id) {
+        size_t mask = slots.size() - 1;
+        size_t i = hashes[id] & mask;
+        while (slots[i] != EMPTY_SLOT) i = (i + 1) & mask;
+        slots[i] = id;
+    }
+
+    void rehash() {
+        slots.assign(slots.size() * 2, EMPTY_SLOT);
+        for (uint32_t id = 0; id < hashes.size(); id++) insertSlot(id);
+    }
+
+    bool flushRecords() {
+        bool ok = writeAll(records.data(), records.size() * sizeof(TokenRecord));
+        records.clear();
+        return ok;
+    }
+
+    bool writeAll(const void* data, size_t size) {
+        const char* p = (const char*)data;
+        while (size > 0) {
+            ssize_t written = ::write(fd, p, size);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            p += written;
+            size -= (size_t)written;
+        }
+        return true;
+    }
+};
+
+class TokenFileReader {
+public:
+    ~TokenFileReader() { close(); }
+
+    // Function to map a token file and check its layout; an open file is closed first,
+    // and on failure the reader is left empty
+    bool open(const char* path) {
+        close();
+        if (!mapFile(path)) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    // Function to unmap the file; the reader is empty afterwards
+    void close() {
+        if (mapped) munmap(mapped, mappedSize);
+        mapped = nullptr;
+        mappedSize = tokenCount = segmentCount = lexemeCount = 0;
+    }
+
+    size_t size() const { return tokenCount; }
+    size_t lexemes() const { return lexemeCount; }
+    const TokenRecord& record(size_t i) const { return records[i]; }
+
+    // A record whose lexeme id is out of range reads as an Error token with no text
+    TokenKind kind(size_t i) const {
+        uint32_t id = records[i].lexeme;
+        return id < lexemeCount ? (TokenKind)kinds[id] : TokenKind::Error;
+    }
+    uint32_t length(size_t i) const { return lexemeLength(records[i].lexeme); }
+    std::string_view text(size_t i) const { return lexeme(records[i].lexeme); }
+
+    // Function to rebuild the full byte offset of token i
+    uint64_t offset(size_t i) const {
+        size_t segment = segmentCount - 1;
+        while (segment > 0 && segmentFirst[segment] > i) segment--;  // One entry per 4 GB
+        return ((uint64_t)segment << 32) | records[i].offsetLow;
+    }
+
+    std::string_view lexeme(uint32_t id) const {
+        if (id >= lexemeCount) return std::string_view();
+        return std::string_view(pool + lexemeIndex[id], lexemeLength(id));
+    }
+
+    uint32_t lexemeLength(uint32_t id) const {
+        return id < lexemeCount ? (uint32_t)(lexemeIndex[id + 1] - lexemeIndex[id]) : 0;
+    }
+
+private:
+    // Function to map path and point the tables into it; false if it cannot be mapped or
+    // its layout is invalid
+    bool mapFile(const char* path) {
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        bool ok = fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(TokenFileHeader);
+        if (ok) {
+            mappedSize = (size_t)st.st_size;
+            void* view = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+            ok = view != MAP_FAILED;
+            if (ok) mapped = (char*)view;
+        }
+        ::close(fd);
+        if (!ok) return false;
+
+        // Every table must lie inside the file, in order and aligned for its
+        // entries, before anything is read from it
+        const TokenFileHeader* header = (const TokenFileHeader*)mapped;
+        if (header->magic != TOKEN_FILE_MAGIC || header->version != TOKEN_FILE_VERSION) return false;
+        if (header->recordsOffset < sizeof(TokenFileHeader) || header->recordsOffset % alignof(TokenRecord) != 0 ||
+            header->segmentsOffset % sizeof(uint64_t) != 0 || header->lexemeIndexOffset % sizeof(uint64_t) != 0 ||
+            header->lexemeCount >= UINT32_MAX || (header->tokenCount > 0 && header->segmentCount == 0) ||
+            !fits(header->recordsOffset, header->tokenCount, sizeof(TokenRecord), header->segmentsOffset) ||
+            !fits(header->segmentsOffset, header->segmentCount, sizeof(uint64_t), header->lexemeIndexOffset) ||
+            !fits(header->lexemeIndexOffset, header->lexemeCount + 1, sizeof(uint64_t), header->lexemeKindsOffset) ||
+            !fits(header->lexemeKindsOffset, header->lexemeCount, 1, header->lexemePoolOffset) ||
+            !fits(header->lexemePoolOffset, header->poolSize, 1, mappedSize)) {
+            return false;
+        }
+
+        tokenCount = header->tokenCount;
+        segmentCount = header->segmentCount;
+        lexemeCount = header->lexemeCount;
+        records = (const TokenRecord*)(mapped + header->recordsOffset);
+        segmentFirst = (const uint64_t*)(mapped + header->segmentsOffset);
+        lexemeIndex = (const uint64_t*)(mapped + header->lexemeIndexOffset);
+        kinds = (const uint8_t*)(mapped + header->lexemeKindsOffset);
+        pool = mapped + header->lexemePoolOffset;
+
+        // Lexemes must run through the pool in order, from its start to its end
+        if (lexemeIndex[0] != 0 || lexemeIndex[lexemeCount] != header->poolSize) return false;
+        for (size_t id = 0; id < lexemeCount; id++) {
+            if (lexemeIndex[id + 1] < lexemeIndex[id] || kinds[id] > (uint8_t)TokenKind::Error) return false;
+        }
+        return true;
+    }
+
+    // Function to check that count entries of size bytes from offset end by limit, without overflowing
+    static bool fits(uint64_t offset, uint64_t count, uint64_t size, uint64_t limit) {
+        return offset <= limit && count <= (limit - offset) / size;
+    }
+
+    char* mapped = nullptr;
+    size_t mappedSize = 0;
+    size_t tokenCount = 0;
+    size_t segmentCount = 0;
+    size_t lexemeCount = 0;
+    const TokenRecord* records = nullptr;
+    const uint64_t* segmentFirst = nullptr;
+    const uint64_t* lexemeIndex = nullptr;
+    const uint8_t* kinds = nullptr;
+    const char* pool = nullptr;
+};
+
+#endif
@@ -0,0 +1,295 @@
+#ifndef FIRST_FOLLOW_H
+#define FIRST_FOLLOW_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "grammar.h"
+
+// FIRST and FOLLOW sets over a Grammar.
+//
+// Sets are bitsets over the grammar's dense terminal indices, kept per dense
+// non-terminal index. Both analyses reduce to "set X must contain set Y"
+// constraints between non-terminals; propagateOverComponents() solves such a
+// graph in a single sweep over its strongly connected components, so left
+// recursion and cycles cost nothing extra and nothing recurses.
+
+// Packed set of terminal indices, one bit per terminal, so union is a word-wise OR
+struct TerminalSet {
+    std::vector<uint64_t> words;
+
+    explicit TerminalSet(size_t terminalCount = 0) : words((terminalCount + 63) / 64) {}
+
+    void insert(int terminal) { words[terminal >> 6] |= 1ULL << (terminal & 63); }
+
+    bool contains(int terminal) const { return words[terminal >> 6] >> (terminal & 63) & 1; }
+
+    void clear() { std::fill(words.begin(), words.end(), 0); }
+
+    // Function to add every member of other; returns true if anything was new
+    bool unite(const TerminalSet& other) {
+        uint64_t added = 0;
+        for (size_t i = 0; i < words.size(); ++i) {
+            uint64_t merged = words[i] | other.words[i];
+            added |= merged ^ words[i];
+            words[i] = merged;
+        }
+        return added != 0;
+    }
+
+    // Function to call visit(terminalIndex) for every member in increasing order
+    template <typename Visit>
+    void forEach(Visit visit) const {
+        for (size_t w = 0; w < words.size(); ++w) {
+            for (uint64_t bits = words[w]; bits; bits &= bits - 1) visit((int)(w * 64 + __builtin_ctzll(bits)));
+        }
+    }
+};
+
+// FIRST of every non-terminal: the terminals plus a flag for epsilon
+struct FirstSets {
+    std::vector<TerminalSet> terminals;
+    std::vector<bool> nullable;
+};
+
+// Function to find the non-terminals that can derive epsilon.
+// Each production counts its symbols not yet known to vanish; when a
+// non-terminal becomes nullable the productions using it count down, so
+// every symbol occurrence is visited a constant number of times.
+inline std::vector<bool> computeNullable(const Grammar& grammar) {
+    std::vector<bool> nullable(grammar.nonTerminalCount(), false);
+    std::vector<std::vector<uint32_t>> usedIn(grammar.nonTerminalCount());
+    std::vector<uint32_t> pending(grammar.productionCount(), 0);
+    std::vector<int> worklist;
+
+    for (uint32_t p = 0; p < grammar.productionCount(); ++p) {
+        SymbolSpan rhs = grammar.rhs(p);
+        bool hasTerminal = false;
+        for (SymbolId sym : rhs) hasTerminal = hasTerminal || !grammar.isNonTerminal(sym);
+        if (hasTerminal) continue; // Can never vanish
+
+        pending[p] = rhs.size();
+        for (SymbolId sym : rhs) usedIn[grammar.nonTerminalIndex(sym)].push_back(p);
+        int lhs = grammar.nonTerminalIndex(grammar.lhs(p));
+        if (rhs.empty() && !nullable[lhs]) {
+            nullable[lhs] = true;
+            worklist.push_back(lhs);
+        }
+    }
+
+    while (!worklist.empty()) {
+        int nt = worklist.back();
+        worklist.pop_back();
+        for (uint32_t p : usedIn[nt]) {
+            int lhs = grammar.nonTerminalIndex(grammar.lhs(p));
+            if (--pending[p] == 0 && !nullable[lhs]) {
+                nullable[lhs] = true;
+                worklist.push_back(lhs);
+            }
+        }
+    }
+    return nullable;
+}
+
+// Function to call visit(members, component) for every strongly connected
+// component of the edge graph, in the order Tarjan's algorithm finishes
+// them: reverse topological, so a component comes after every component it
+// points to. component[v] is the root (the last member) of v's component
+// for every node finished so far. Iterative, so deep graphs cannot overflow
+// the call stack.
+template <typename Visit>
+inline void forEachComponent(const std::vector<std::vector<int>>& edges, Visit visit) {
+    size_t count = edges.size();
+    const int unvisited = -1;
+    std::vector<int> index(count, unvisited), lowLink(count, 0), component(count, unvisited);
+    std::vector<int> sccStack, members;
+    std::vector<std::pair<int, size_t>> callStack; // (node, next edge to follow)
+    int nextIndex = 0;
+
+    for (size_t root = 0; root < count; ++root) {
+        if (index[root] != unvisited) continue;
+        callStack.push_back({(int)root, 0});
+        index[root] = lowLink[root] = nextIndex++;
+        sccStack.push_back(root);
+
+        while (!callStack.empty()) {
+            int node = callStack.back().first;
+            size_t& edge = callStack.back().second;
+
+            if (edge < edges[node].size()) {
+                int next = edges[node][edge++];
+                if (index[next] == unvisited) {
+                    index[next] = lowLink[next] = nextIndex++;
+                    sccStack.push_back(next);
+                    callStack.push_back({next, 0});
+                } else if (component[next] == unvisited) {
+                    lowLink[node] = std::min(lowLink[node], index[next]); // Still on the stack
+                }
+                continue;
+            }
+
+            callStack.pop_back();
+            if (!callStack.empty()) {
+                int parent = callStack.back().first;
+                lowLink[parent] = std::min(lowLink[parent], lowLink[node]);
+            }
+            if (lowLink[node] != index[node]) continue;
+
+            // node roots a finished component: gather its members
+            members.clear();
+            int member;
+            do {
+                member = sccStack.back();
+                sccStack.pop_back();
+                component[member] = node;
+                members.push_back(member);
+            } while (member != node);
+            visit(members, component);
+        }
+    }
+}
+
+// Function to make sets[i] contain sets[j] for every edge i -> j.
+// The strongly connected components of the edge graph end up sharing one
+// set. Each component only needs the finished sets of the components it
+// points to, which forEachComponent has already visited: one pass, no
+// recursion and no repeated visits.
+inline void propagateOverComponents(const std::vector<std::vector<int>>& edges, std::vector<TerminalSet>& sets) {
+    forEachComponent(edges, [&](const std::vector<int>& members, const std::vector<int>& component) {
+        int root = members.back();
+        TerminalSet& merged = sets[root];
+        for (int m : members) {
+            if (m != root) merged.unite(sets[m]);
+            for (int next : edges[m]) {
+                if (component[next] != root) merged.unite(sets[component[next]]);
+            }
+        }
+        for (int m : members) {
+            if (m != root) sets[m] = merged;
+        }
+    });
+}
+
+// Function to compute FIRST sets for all non-terminals.
+// FIRST(A) contains FIRST(B) whenever B can start a production of A.
+inline FirstSets computeAllFirst(const Grammar& grammar) {
+    size_t count = grammar.nonTerminalCount();
+    FirstSets firstSets;
+    firstSets.nullable = computeNullable(grammar);
+    firstSets.terminals.assign(count, TerminalSet(grammar.terminalCount()));
+
+    // Terminals that start a production directly, and the non-terminals that can start one
+    std::vector<std::vector<int>> startsWith(count);
+    for (uint32_t p = 0; p < grammar.productionCount(); ++p) {
+        int lhs = grammar.nonTerminalIndex(grammar.lhs(p));
+        for (SymbolId sym : grammar.rhs(p)) {
+            int symIndex = grammar.nonTerminalIndex(sym);
+            if (symIndex < 0) {
+                firstSets.terminals[lhs].insert(grammar.terminalIndex(sym));
+                break;
+            }
+            startsWith[lhs].push_back(symIndex);
+            if (!firstSets.nullable[symIndex]) break;
+        }
+    }
+
+    propagateOverComponents(startsWith, firstSets.terminals);
+    return firstSets;
+}
+
+// Function to compute FOLLOW sets; endMarker is the terminal added for the
+// start symbol (the first non-terminal), usually "$".
+// For every occurrence A -> α B β the terminals of FIRST(β) go straight into
+// FOLLOW(B), and if β can vanish FOLLOW(B) must contain FOLLOW(A). FIRST(β)
+// is built once per production by walking it right to left, so each suffix
+// costs one bitset operation.
+inline std::vector<TerminalSet> computeFollow(const Grammar& grammar, const FirstSets& firstSets,
+                                              SymbolId endMarker) {
+    size_t count = grammar.nonTerminalCount();
+    std::vector<TerminalSet> followSets(count, TerminalSet(grammar.terminalCount()));
+    std::vector<std::vector<int>> includesFollowOf(count);
+
+    // Step 1: Add $ to FOLLOW of start symbol (unless the name was taken by a non-terminal)
+    if (count > 0 && grammar.terminalIndex(endMarker) >= 0) {
+        followSets[0].insert(grammar.terminalIndex(endMarker));
+    }
+
+    // Step 2: Process each production right to left, carrying FIRST of the suffix
+    TerminalSet suffixFirst(grammar.terminalCount());
+    for (uint32_t p = 0; p < grammar.productionCount(); ++p) {
+        int lhs = grammar.nonTerminalIndex(grammar.lhs(p));
+        SymbolSpan rhs = grammar.rhs(p);
+        suffixFirst.clear();
+        bool suffixNullable = true;
+
+        for (size_t j = rhs.size(); j-- > 0;) {
+            int bIndex = grammar.nonTerminalIndex(rhs[j]);
+            if (bIndex < 0) {
+                suffixFirst.clear();
+                suffixFirst.insert(grammar.terminalIndex(rhs[j]));
+                suffixNullable = false;
+                continue;
+            }
+
+            // Add FIRST(β) - {ε} to FOLLOW(B); if β can be ε, FOLLOW(B) includes FOLLOW(A)
+            followSets[bIndex].unite(suffixFirst);
+            if (suffixNullable && bIndex != lhs) includesFollowOf[bIndex].push_back(lhs);
+
+            // Extend the suffix by B
+            if (firstSets.nullable[bIndex]) {
+                suffixFirst.unite(firstSets.terminals[bIndex]);
+            } else {
+                suffixFirst = firstSets.terminals[bIndex];
+                suffixNullable = false;
+            }
+        }
+    }
+
+    // Step 3: Propagate FOLLOW(A) into FOLLOW(B) along the containments
+    propagateOverComponents(includesFollowOf, followSets);
+    return followSets;
+}
+
+// Function to write one "A -> { a, b, ε }" line per non-terminal; epsilon is
+// added last for the non-terminals flagged in nullable (pass none for FOLLOW)
+inline bool writeSets(const Grammar& grammar, const std::vector<TerminalSet>& sets,
+                      const std::vector<bool>& nullable, const std::string& filename) {
+    std::ofstream file(filename);
+    if (!file.is_open()) return false;
+
+    std::string text;
+    for (size_t i = 0; i < grammar.nonTerminalCount(); ++i) {
+        text += grammar.name(grammar.nonTerminal(i));
+        text += " -> { ";
+        bool firstItem = true;
+        sets[i].forEach([&](int terminal) {
+            if (!firstItem) text += ", ";
+            text += grammar.name(grammar.terminal(terminal));
+            firstItem = false;
+        });
+        if (i < nullable.size() && nullable[i]) {
+            if (!firstItem) text += ", ";
+            text += grammar.epsilon();
+        }
+        text += " }\n";
+    }
+    file << text;
+    return (bool)file;
+}
+
+// Function to write FIRST sets, terminals in order of first appearance and epsilon last
+inline bool writeFirstSets(const Grammar& grammar, const FirstSets& firstSets, const std::string& filename) {
+    return writeSets(grammar, firstSets.terminals, firstSets.nullable, filename);
+}
+
+// Function to write FOLLOW sets, terminals in order of first appearance
+inline bool writeFollowSets(const Grammar& grammar, const std::vector<TerminalSet>& followSets,
+                            const std::string& filename) {
+    return writeSets(grammar, followSets, std::vector<bool>(), filename);
+}
+
+#endif
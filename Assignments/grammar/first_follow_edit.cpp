@@ -0,0 +1,120 @@
+#include <iostream>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include "incremental_first_follow.h"
+
+using namespace std;
+
+// Interactive FIRST/FOLLOW: load a grammar once, then edit its productions
+// and see the sets change without re-running the First and Follow programs.
+// Only the sets that depend on an edit are recomputed.
+// Build: g++ -O2 -std=c++17 first_follow_edit.cpp -o first_follow_edit
+// Usage: ./first_follow_edit grammar.txt, then one command per line:
+//   + A -> x B      add a production (ε for an empty one)
+//   - A -> x B      remove it again
+//   ? A             print FIRST(A) and FOLLOW(A)
+//   w first.txt follow.txt   write every set
+//   q               quit
+// Edits may only use symbols the grammar already has.
+
+// Function to format a set as "{ a, b, ε }"
+string formatSet(const Grammar& symbols, const TerminalSet& set, bool nullable) {
+    string text = "{ ";
+    bool firstItem = true;
+    set.forEach([&](int terminal) {
+        if (!firstItem) text += ", ";
+        text += symbols.name(symbols.terminal(terminal));
+        firstItem = false;
+    });
+    if (nullable) {
+        if (!firstItem) text += ", ";
+        text += symbols.epsilon();
+    }
+    return text + " }";
+}
+
+// Function to parse "A -> x B" into symbol IDs; false if a name is unknown
+bool parseRule(const Grammar& symbols, istringstream& in, SymbolId& lhs, SymbolString& rhs) {
+    string name, arrow;
+    if (!(in >> name >> arrow) || arrow != "->") return false;
+    lhs = symbols.find(name);
+    if (lhs == NO_SYMBOL) return false;
+    rhs.clear();
+    while (in >> name) {
+        if (name == symbols.epsilon() || name == "epsilon") continue;
+        SymbolId sym = symbols.find(name);
+        if (sym == NO_SYMBOL) return false;
+        rhs.push_back(sym);
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cout << "Usage: " << argv[0] << " grammar.txt" << endl;
+        return 1;
+    }
+
+    // The end marker is interned first so it is terminal 0
+    Grammar grammar;
+    SymbolId endMarker = grammar.intern("$");
+    if (!grammar.load(argv[1])) {
+        cout << "Error opening file: " << argv[1] << endl;
+        return 1;
+    }
+    IncrementalFirstFollow sets(grammar, endMarker);
+    const Grammar& symbols = sets.symbolTable();
+    cout << grammar.nonTerminalCount() << " non-terminals, " << grammar.productionCount() << " productions" << endl;
+
+    string line;
+    while (getline(cin, line)) {
+        istringstream in(line);
+        string command;
+        if (!(in >> command)) continue;
+        if (command == "q") break;
+
+        if (command == "+" || command == "-") {
+            SymbolId lhs;
+            SymbolString rhs;
+            if (!parseRule(symbols, in, lhs, rhs)) {
+                cout << "Expected a rule over known symbols, e.g. + A -> x B" << endl;
+                continue;
+            }
+            auto start = chrono::steady_clock::now();
+            bool done = command == "+" ? sets.addProduction(lhs, rhs) : sets.removeProduction(lhs, rhs);
+            double us = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+            if (!done) {
+                cout << (command == "+" ? "Left side is not a non-terminal" : "No such production") << endl;
+                continue;
+            }
+            const IncrementalUpdateStats& stats = sets.lastUpdate();
+            cout << "Updated in " << us << " us (recomputed " << stats.nullable << " nullable, " << stats.first
+                 << " FIRST, " << stats.follow << " FOLLOW)" << endl;
+        } else if (command == "?") {
+            string name;
+            in >> name;
+            SymbolId nt = symbols.find(name);
+            if (nt == NO_SYMBOL || !symbols.isNonTerminal(nt)) {
+                cout << "Unknown non-terminal: " << name << endl;
+                continue;
+            }
+            int i = symbols.nonTerminalIndex(nt);
+            cout << "FIRST(" << name << ") = " << formatSet(symbols, sets.first().terminals[i], sets.first().nullable[i])
+                 << "\nFOLLOW(" << name << ") = " << formatSet(symbols, sets.follow()[i], false) << endl;
+        } else if (command == "w") {
+            string firstFile, followFile;
+            if (!(in >> firstFile >> followFile)) {
+                cout << "Usage: w first.txt follow.txt" << endl;
+                continue;
+            }
+            if (!writeFirstSets(symbols, sets.first(), firstFile) ||
+                !writeFollowSets(symbols, sets.follow(), followFile)) {
+                cout << "Cannot write " << firstFile << " or " << followFile << endl;
+            }
+        } else {
+            cout << "Commands: + rule, - rule, ? A, w first.txt follow.txt, q" << endl;
+        }
+    }
+    return 0;
+}
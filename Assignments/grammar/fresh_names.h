@@ -0,0 +1,58 @@
+#ifndef FRESH_NAMES_H
+#define FRESH_NAMES_H
+
+#include <cstdint>
+#include <string>
+#include "grammar.h"
+
+// Fresh non-terminal names for the grammar transformations.
+//
+// Names are checked against the grammar's symbol table, so a generated name
+// never reuses a symbol of the input or an earlier generated one; each check
+// is one hash lookup. Two families are handed out:
+//   letters  B, C, ..., Z, AA, AB, ..., ZZ, AAA, ... (left factoring)
+//   primes   A', then A'2, A'3, ... if A' is taken (left recursion)
+// Letter names are the bijective base-26 numerals from 2 on, so there is no
+// limit on how many can be generated. Every name is interned on creation.
+
+class FreshNames {
+public:
+    explicit FreshNames(Grammar& grammar) : grammar(grammar) {}
+
+    // Function to intern the next unused letter name
+    SymbolId letter() {
+        for (;;) {
+            std::string name = letterName(nextLetter++);
+            if (grammar.find(name) == NO_SYMBOL) return grammar.intern(name);
+        }
+    }
+
+    // Function to intern an unused primed name for `base`, e.g. E' for E
+    SymbolId prime(SymbolId base) {
+        std::string name = std::string(grammar.name(base)) + "'";
+        if (grammar.find(name) == NO_SYMBOL) return grammar.intern(name);
+        size_t stem = name.size();
+        for (uint64_t n = 2;; ++n) {
+            name.resize(stem);
+            name += std::to_string(n);
+            if (grammar.find(name) == NO_SYMBOL) return grammar.intern(name);
+        }
+    }
+
+private:
+    Grammar& grammar;
+    uint64_t nextLetter = 2; // Start after 'A'
+
+    // Function to spell n in bijective base 26: 1 -> A, 26 -> Z, 27 -> AA
+    static std::string letterName(uint64_t n) {
+        std::string name;
+        while (n > 0) {
+            n--;
+            name += (char)('A' + n % 26);
+            n /= 26;
+        }
+        return std::string(name.rbegin(), name.rend());
+    }
+};
+
+#endif
@@ -0,0 +1,344 @@
+#ifndef GRAMMAR_H
+#define GRAMMAR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Context-free grammar shared by the grammar tools.
+//
+// Every symbol name is copied once into a single character pool and interned
+// to a dense SymbolId through an open-addressing hash table, so a lookup is
+// one hash and usually one compare, and names are never copied again.
+// Productions are flat: all right-hand sides sit back to back in one symbol
+// array, and an index groups the productions of each non-terminal
+// contiguously (CSR), in the order they were added. An epsilon production is
+// an empty right-hand side.
+//
+// A symbol is a non-terminal once it has a production or is declared one;
+// every other symbol is a terminal. A non-terminal without productions
+// derives nothing and is written as "A ->" with an empty right side. Both kinds also get dense indices (in order of definition and
+// of symbol ID respectively) so analyses can keep plain arrays and bitsets.
+//
+// Text format, one or more rules per non-terminal:
+//   E -> T E'
+//   E' -> + T E' | ε
+// Symbols are separated by spaces; "ε" and "epsilon" both stand for the
+// empty string.
+
+#define GRAMMAR_EPSILON "ε"
+
+typedef int32_t SymbolId;
+#define NO_SYMBOL (-1)
+
+// Editable right-hand side for grammar transformations; empty for ε
+typedef std::vector<SymbolId> SymbolString;
+
+// Contiguous run of symbols, e.g. one right-hand side
+struct SymbolSpan {
+    const SymbolId* first;
+    const SymbolId* last;
+
+    const SymbolId* begin() const { return first; }
+    const SymbolId* end() const { return last; }
+    size_t size() const { return last - first; }
+    bool empty() const { return first == last; }
+    SymbolId operator[](size_t i) const { return first[i]; }
+};
+
+// Contiguous run of production IDs, e.g. all productions of one non-terminal
+struct ProductionSpan {
+    const uint32_t* first;
+    const uint32_t* last;
+
+    const uint32_t* begin() const { return first; }
+    const uint32_t* end() const { return last; }
+    size_t size() const { return last - first; }
+    bool empty() const { return first == last; }
+    uint32_t operator[](size_t i) const { return first[i]; }
+};
+
+class Grammar {
+public:
+    Grammar() : slots(64, NO_SYMBOL) {}
+
+    // Function to find or add a symbol by name
+    SymbolId intern(std::string_view name) {
+        uint32_t h = hashName(name);
+        size_t mask = slots.size() - 1;
+        for (size_t i = h & mask;; i = (i + 1) & mask) {
+            SymbolId id = slots[i];
+            if (id == NO_SYMBOL) break;
+            if (hashes[id] == h && this->name(id) == name) return id;
+        }
+
+        SymbolId id = (SymbolId)hashes.size();
+        pool.insert(pool.end(), name.begin(), name.end());
+        nameIndex.push_back(pool.size());
+        hashes.push_back(h);
+        nonTerminalIndexOf.push_back(-1);
+        indexed = false;
+        if (hashes.size() * 2 > slots.size()) {
+            rehash();
+        } else {
+            insertSlot(id);
+        }
+        return id;
+    }
+
+    // Function to look a symbol up without adding it; NO_SYMBOL if unknown
+    SymbolId find(std::string_view name) const {
+        uint32_t h = hashName(name);
+        size_t mask = slots.size() - 1;
+        for (size_t i = h & mask;; i = (i + 1) & mask) {
+            SymbolId id = slots[i];
+            if (id == NO_SYMBOL) return NO_SYMBOL;
+            if (hashes[id] == h && this->name(id) == name) return id;
+        }
+    }
+
+    std::string_view name(SymbolId id) const {
+        return std::string_view(pool.data() + nameIndex[id], nameIndex[id + 1] - nameIndex[id]);
+    }
+
+    size_t symbolCount() const { return hashes.size(); }
+
+    // Function to make a symbol a non-terminal, even if it never gets a production
+    void addNonTerminal(SymbolId id) {
+        if (nonTerminalIndexOf[id] >= 0) return;
+        nonTerminalIndexOf[id] = (int)nonTerminalList.size();
+        nonTerminalList.push_back(id);
+        indexed = false;
+    }
+
+    // Function to add lhs -> rhs; lhs becomes a non-terminal. Returns the production ID.
+    uint32_t addProduction(SymbolId lhs, const SymbolId* rhs, size_t length) {
+        addNonTerminal(lhs);
+        rhsSymbols.insert(rhsSymbols.end(), rhs, rhs + length);
+        rhsStart.push_back((uint32_t)rhsSymbols.size());
+        lhsOf.push_back(lhs);
+        indexed = false;
+        return (uint32_t)lhsOf.size() - 1;
+    }
+
+    uint32_t addProduction(SymbolId lhs, const SymbolString& rhs) {
+        return addProduction(lhs, rhs.data(), rhs.size());
+    }
+
+    // Function to drop every production but keep the symbols and their IDs, so a
+    // transformed grammar can be built on a copy with the same numbering
+    void clearProductions() {
+        for (SymbolId nt : nonTerminalList) nonTerminalIndexOf[nt] = -1;
+        nonTerminalList.clear();
+        rhsSymbols.clear();
+        rhsStart.assign(1, 0);
+        lhsOf.clear();
+        indexed = false;
+    }
+
+    size_t productionCount() const { return lhsOf.size(); }
+    SymbolId lhs(uint32_t production) const { return lhsOf[production]; }
+    SymbolSpan rhs(uint32_t production) const {
+        return SymbolSpan{rhsSymbols.data() + rhsStart[production], rhsSymbols.data() + rhsStart[production + 1]};
+    }
+
+    // Non-terminals, densely numbered in order of their first production
+    size_t nonTerminalCount() const { return nonTerminalList.size(); }
+    SymbolId nonTerminal(size_t index) const { return nonTerminalList[index]; }
+    int nonTerminalIndex(SymbolId id) const { return nonTerminalIndexOf[id]; }
+    bool isNonTerminal(SymbolId id) const { return nonTerminalIndexOf[id] >= 0; }
+
+    // Terminals, densely numbered in symbol ID order (order of first appearance)
+    size_t terminalCount() const { return buildIndex().terminalList.size(); }
+    SymbolId terminal(size_t index) const { return buildIndex().terminalList[index]; }
+    int terminalIndex(SymbolId id) const { return buildIndex().terminalIndexOf[id]; }
+
+    // Productions of the non-terminal with dense index `index`, in the order they were added
+    ProductionSpan productionsOf(size_t index) const {
+        const Index& built = buildIndex();
+        return ProductionSpan{built.byLhs.data() + built.byLhsStart[index],
+                              built.byLhs.data() + built.byLhsStart[index + 1]};
+    }
+
+    // Spelling used for the empty string when writing; taken from the input
+    const std::string& epsilon() const { return epsilonName; }
+
+    // Function to read rules in the text format; false if the file cannot be opened
+    bool load(const std::string& filename) {
+        std::ifstream file(filename);
+        if (!file.is_open()) return false;
+        std::stringstream text;
+        text << file.rdbuf();
+        parse(text.str());
+        return true;
+    }
+
+    // Function to add the rules in `text`. Every left side is interned before any
+    // right side, so symbols defined later in the text are still non-terminals.
+    // A rule with nothing after the arrow declares a non-terminal without
+    // productions; ε must be spelled out.
+    void parse(const std::string& text) {
+        std::vector<std::pair<SymbolId, std::string_view>> rules;
+        std::string_view rest(text);
+        while (!rest.empty()) {
+            size_t lineEnd = rest.find('\n');
+            std::string_view line = rest.substr(0, lineEnd);
+            rest = lineEnd == std::string_view::npos ? std::string_view() : rest.substr(lineEnd + 1);
+
+            size_t arrow = line.find("->");
+            if (arrow == std::string_view::npos) continue;
+            std::string_view lhsName = trim(line.substr(0, arrow));
+            if (lhsName.empty()) continue;
+
+            SymbolId lhs = intern(lhsName);
+            addNonTerminal(lhs);
+            rules.push_back({lhs, line.substr(arrow + 2)});
+        }
+
+        std::vector<SymbolId> symbols;
+        for (const auto& rule : rules) {
+            std::string_view alternatives = rule.second;
+            if (trim(alternatives).empty()) continue; // "A ->" only declares A
+            while (true) {
+                size_t bar = alternatives.find('|');
+                symbols.clear();
+                std::string_view alternative = alternatives.substr(0, bar);
+                while (true) {
+                    size_t start = alternative.find_first_not_of(" \t\r");
+                    if (start == std::string_view::npos) break;
+                    alternative.remove_prefix(start);
+                    size_t length = std::min(alternative.find_first_of(" \t\r"), alternative.size());
+                    std::string_view symbol = alternative.substr(0, length);
+                    alternative.remove_prefix(length);
+                    if (symbol == "ε" || symbol == "epsilon") {
+                        epsilonName = std::string(symbol);
+                    } else {
+                        symbols.push_back(intern(symbol));
+                    }
+                }
+                addProduction(rule.first, symbols);
+                if (bar == std::string_view::npos) break;
+                alternatives.remove_prefix(bar + 1);
+            }
+        }
+    }
+
+    // Function to format one production's right-hand side, e.g. "+ T E'" or "ε"
+    std::string formatRhs(uint32_t production) const {
+        SymbolSpan symbols = rhs(production);
+        if (symbols.empty()) return epsilonName;
+        std::string text;
+        for (size_t i = 0; i < symbols.size(); i++) {
+            if (i > 0) text += ' ';
+            text += name(symbols[i]);
+        }
+        return text;
+    }
+
+    // Function to write the grammar in the text format, one line per non-terminal.
+    // With sortByName the lines are ordered by name instead of by definition.
+    bool write(const std::string& filename, bool sortByName = false) const {
+        std::ofstream file(filename);
+        if (!file.is_open()) return false;
+
+        std::vector<size_t> order(nonTerminalCount());
+        for (size_t i = 0; i < order.size(); i++) order[i] = i;
+        if (sortByName) {
+            std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+                return name(nonTerminal(a)) < name(nonTerminal(b));
+            });
+        }
+
+        std::string text;
+        for (size_t i : order) {
+            text += name(nonTerminal(i));
+            text += " ->";
+            ProductionSpan productions = productionsOf(i);
+            for (size_t p = 0; p < productions.size(); p++) {
+                text += p > 0 ? " | " : " ";
+                text += formatRhs(productions[p]);
+            }
+            text += '\n';
+        }
+        file << text;
+        return (bool)file;
+    }
+
+private:
+    // Lookup arrays derived from the productions, rebuilt after a change
+    struct Index {
+        std::vector<uint32_t> byLhsStart;    // Per non-terminal, first slot in byLhs
+        std::vector<uint32_t> byLhs;         // Production IDs grouped by left side
+        std::vector<SymbolId> terminalList;
+        std::vector<int> terminalIndexOf;    // Per symbol, -1 for non-terminals
+    };
+
+    std::vector<char> pool;                  // Every symbol name once
+    std::vector<size_t> nameIndex{0};        // Start of each name in pool
+    std::vector<uint32_t> hashes;            // Hash of each name
+    std::vector<SymbolId> slots;             // Open-addressing table of symbol IDs
+    std::vector<int> nonTerminalIndexOf;     // Per symbol, -1 for terminals
+    std::vector<SymbolId> nonTerminalList;
+
+    std::vector<SymbolId> rhsSymbols;        // All right-hand sides back to back
+    std::vector<uint32_t> rhsStart{0};       // Start of each production in rhsSymbols
+    std::vector<SymbolId> lhsOf;
+
+    std::string epsilonName = GRAMMAR_EPSILON;
+    mutable Index built;
+    mutable bool indexed = false;
+
+    static uint32_t hashName(std::string_view s) {
+        uint32_t h = 2166136261u;
+        for (char ch : s) h = (h ^ (unsigned char)ch) * 16777619u;
+        return h;
+    }
+
+    static std::string_view trim(std::string_view s) {
+        size_t first = s.find_first_not_of(" \t\r");
+        if (first == std::string_view::npos) return std::string_view();
+        size_t last = s.find_last_not_of(" \t\r");
+        return s.substr(first, last - first + 1);
+    }
+
+    void insertSlot(SymbolId id) {
+        size_t mask = slots.size() - 1;
+        size_t i = hashes[id] & mask;
+        while (slots[i] != NO_SYMBOL) i = (i + 1) & mask;
+        slots[i] = id;
+    }
+
+    void rehash() {
+        slots.assign(slots.size() * 2, NO_SYMBOL);
+        for (SymbolId id = 0; id < (SymbolId)hashes.size(); id++) insertSlot(id);
+    }
+
+    // Function to build the CSR production index and the terminal numbering
+    const Index& buildIndex() const {
+        if (indexed) return built;
+        size_t count = nonTerminalList.size();
+        built.byLhsStart.assign(count + 1, 0);
+        for (SymbolId lhs : lhsOf) built.byLhsStart[nonTerminalIndexOf[lhs] + 1]++;
+        for (size_t i = 0; i < count; i++) built.byLhsStart[i + 1] += built.byLhsStart[i];
+        built.byLhs.resize(lhsOf.size());
+        std::vector<uint32_t> fill(built.byLhsStart.begin(), built.byLhsStart.end() - 1);
+        for (uint32_t p = 0; p < lhsOf.size(); p++) built.byLhs[fill[nonTerminalIndexOf[lhsOf[p]]]++] = p;
+
+        built.terminalList.clear();
+        built.terminalIndexOf.assign(symbolCount(), -1);
+        for (SymbolId id = 0; id < (SymbolId)symbolCount(); id++) {
+            if (nonTerminalIndexOf[id] >= 0) continue;
+            built.terminalIndexOf[id] = (int)built.terminalList.size();
+            built.terminalList.push_back(id);
+        }
+        indexed = true;
+        return built;
+    }
+};
+
+#endif
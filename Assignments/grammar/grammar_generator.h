@@ -0,0 +1,207 @@
+#ifndef GRAMMAR_GENERATOR_H
+#define GRAMMAR_GENERATOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include "grammar.h"
+
+// Synthetic grammars for benchmarking the grammar tools at scale.
+//
+// Each shape stresses one stage:
+//   random           productions over any non-terminals, so FIRST and FOLLOW see
+//                    large cycles; left positions only refer forward, so
+//                    left-recursion removal stays linear
+//   left-chains      chains of indirect left recursion A0 -> A1 a | b, ...,
+//                    A(k-1) -> A0 a | b, plus immediate left recursion
+//   shared-prefixes  many alternatives sharing long prefixes, for left factoring
+//   epsilon          mostly nullable non-terminals, for the nullable and
+//                    suffix handling in FIRST and FOLLOW
+//   expression       one left-recursive precedence level per non-terminal, the
+//                    shape of a real expression grammar
+//   left-cycles      one left cycle through every non-terminal, each leading
+//                    the next in two alternatives, A0 -> A1 a | A1 b | c, ...,
+//                    A(n-1) -> A0 a | c; substitution doubles the productions
+//                    per member, so left-recursion removal hits its limit
+// Non-terminals are named N00000, N00001, ... so that name order (the order
+// left-recursion removal works in) is index order; terminals are t0, t1, ...
+// The same shape, size and seed always give the same grammar.
+
+#define GENERATOR_CHAIN_LENGTH 64  // Non-terminals per left-recursion chain
+
+enum class GrammarShape { Random, LeftChains, SharedPrefixes, Epsilon, Expression, LeftCycles };
+
+struct GrammarShapeInfo {
+    const char* name;
+    GrammarShape shape;
+};
+
+static const GrammarShapeInfo grammarShapes[] = {
+    {"random", GrammarShape::Random},
+    {"left-chains", GrammarShape::LeftChains},
+    {"shared-prefixes", GrammarShape::SharedPrefixes},
+    {"epsilon", GrammarShape::Epsilon},
+    {"expression", GrammarShape::Expression},
+    {"left-cycles", GrammarShape::LeftCycles},
+};
+
+class GrammarGenerator {
+public:
+    GrammarGenerator(Grammar& grammar, size_t nonTerminals, uint32_t seed)
+        : grammar(grammar), rng(seed), terminalCount(8 + nonTerminals / 16) {
+        // Intern every non-terminal up front so IDs and dense indices follow the numbering
+        for (size_t i = 0; i < nonTerminals; ++i) {
+            char name[24];
+            snprintf(name, sizeof(name), "N%05zu", i);
+            nonTerminalIds.push_back(grammar.intern(name));
+        }
+        for (size_t i = 0; i < terminalCount; ++i) terminalIds.push_back(grammar.intern("t" + std::to_string(i)));
+    }
+
+    // Function to add the productions of one shape
+    void generate(GrammarShape shape) {
+        switch (shape) {
+        case GrammarShape::Random: generateRandom(); break;
+        case GrammarShape::LeftChains: generateLeftChains(); break;
+        case GrammarShape::SharedPrefixes: generateSharedPrefixes(); break;
+        case GrammarShape::Epsilon: generateEpsilon(); break;
+        case GrammarShape::Expression: generateExpression(); break;
+        case GrammarShape::LeftCycles: generateLeftCycles(); break;
+        }
+    }
+
+private:
+    Grammar& grammar;
+    std::mt19937 rng;
+    size_t terminalCount;
+    std::vector<SymbolId> nonTerminalIds, terminalIds;
+    SymbolString rhs;
+
+    size_t pick(size_t count) { return rng() % count; }
+    bool chance(unsigned percent) { return rng() % 100 < percent; }
+    SymbolId anyTerminal() { return terminalIds[pick(terminalIds.size())]; }
+    SymbolId laterNonTerminal(size_t i) {
+        return nonTerminalIds[i + 1 + pick(nonTerminalIds.size() - i - 1)];
+    }
+    size_t count() const { return nonTerminalIds.size(); }
+
+    void generateRandom() {
+        for (size_t i = 0; i < count(); ++i) {
+            size_t alternatives = 1 + pick(4);
+            for (size_t a = 0; a < alternatives; ++a) {
+                rhs.clear();
+                if (chance(10)) {
+                    grammar.addProduction(nonTerminalIds[i], rhs);
+                    continue;
+                }
+                size_t length = 1 + pick(5);
+                for (size_t s = 0; s < length; ++s) {
+                    bool leading = s == 0;
+                    if (chance(50) && (!leading || i + 1 < count())) {
+                        rhs.push_back(leading ? laterNonTerminal(i) : nonTerminalIds[pick(count())]);
+                    } else {
+                        rhs.push_back(anyTerminal());
+                    }
+                }
+                grammar.addProduction(nonTerminalIds[i], rhs);
+            }
+        }
+    }
+
+    void generateLeftChains() {
+        for (size_t i = 0; i < count(); ++i) {
+            size_t chainStart = i - i % GENERATOR_CHAIN_LENGTH;
+            size_t chainEnd = std::min(chainStart + GENERATOR_CHAIN_LENGTH, count());
+            size_t next = i + 1 < chainEnd ? i + 1 : chainStart;
+
+            // Ai -> A(i+1) a | b, closing the chain back to its first non-terminal
+            rhs.assign({nonTerminalIds[next], anyTerminal()});
+            grammar.addProduction(nonTerminalIds[i], rhs);
+            if (chance(25)) {
+                rhs.assign({nonTerminalIds[i], anyTerminal()});
+                grammar.addProduction(nonTerminalIds[i], rhs);
+            }
+            rhs.assign({anyTerminal()});
+            if (chance(50)) rhs.push_back(anyTerminal());
+            grammar.addProduction(nonTerminalIds[i], rhs);
+        }
+    }
+
+    void generateSharedPrefixes() {
+        // Few distinct leading symbols, so alternatives collide on long prefixes
+        size_t alphabet = std::min<size_t>(4, terminalIds.size());
+        for (size_t i = 0; i < count(); ++i) {
+            size_t alternatives = 2 + pick(7);
+            for (size_t a = 0; a < alternatives; ++a) {
+                rhs.clear();
+                size_t length = 1 + pick(6);
+                for (size_t s = 0; s < length; ++s) rhs.push_back(terminalIds[pick(alphabet)]);
+                if (i + 1 < count() && chance(30)) rhs.push_back(laterNonTerminal(i));
+                grammar.addProduction(nonTerminalIds[i], rhs);
+            }
+        }
+    }
+
+    void generateEpsilon() {
+        for (size_t i = 0; i < count(); ++i) {
+            rhs.clear();
+            if (chance(60)) grammar.addProduction(nonTerminalIds[i], rhs);
+            size_t alternatives = 1 + pick(3);
+            for (size_t a = 0; a < alternatives; ++a) {
+                rhs.clear();
+                size_t length = 1 + pick(6);
+                for (size_t s = 0; s < length; ++s) {
+                    if (chance(80)) {
+                        rhs.push_back(s == 0 && i + 1 < count() ? laterNonTerminal(i) : nonTerminalIds[pick(count())]);
+                    } else {
+                        rhs.push_back(anyTerminal());
+                    }
+                }
+                grammar.addProduction(nonTerminalIds[i], rhs);
+            }
+        }
+    }
+
+    void generateExpression() {
+        // Level i: Ei -> Ei op E(i+1) | E(i+1); the last level is the primary expression
+        SymbolId open = grammar.intern("("), close = grammar.intern(")"), id = grammar.intern("id");
+        for (size_t i = 0; i < count(); ++i) {
+            if (i + 1 < count()) {
+                rhs.assign({nonTerminalIds[i], terminalIds[i % terminalIds.size()], nonTerminalIds[i + 1]});
+                grammar.addProduction(nonTerminalIds[i], rhs);
+                rhs.assign({nonTerminalIds[i + 1]});
+                grammar.addProduction(nonTerminalIds[i], rhs);
+            } else {
+                rhs.assign({open, nonTerminalIds[0], close});
+                grammar.addProduction(nonTerminalIds[i], rhs);
+                rhs.assign({id});
+                grammar.addProduction(nonTerminalIds[i], rhs);
+            }
+        }
+    }
+
+    void generateLeftCycles() {
+        for (size_t i = 0; i < count(); ++i) {
+            SymbolId next = nonTerminalIds[(i + 1) % count()];
+            rhs.assign({next, anyTerminal()});
+            grammar.addProduction(nonTerminalIds[i], rhs);
+            if (i + 1 < count()) {
+                rhs.assign({next, anyTerminal()});
+                grammar.addProduction(nonTerminalIds[i], rhs);
+            }
+            rhs.assign({anyTerminal()});
+            grammar.addProduction(nonTerminalIds[i], rhs);
+        }
+    }
+};
+
+// Function to add a generated grammar of the given shape to `grammar`
+inline void generateGrammar(Grammar& grammar, GrammarShape shape, size_t nonTerminals, uint32_t seed) {
+    GrammarGenerator(grammar, nonTerminals, seed).generate(shape);
+}
+
+#endif
@@ -0,0 +1,151 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "first_follow.h"
+#include "left_factoring.h"
+#include "left_recursion.h"
+#include "ll1_table.h"
+#include "lr_table.h"
+#include "parser_codegen.h"
+
+using namespace std;
+
+// Whole grammar build in one process: left-recursion removal, left factoring,
+// FIRST, FOLLOW and the LL(1) table over one in-memory Grammar. Each stage
+// hands the next the Grammar (or the sets) directly, so the grammar is parsed
+// once and only the outputs asked for are written, at the end. The LR table
+// is built from the input grammar as written, since LR parsing needs neither
+// rewrite. --emit-ll1 and --emit-lr write a parser specialised to the grammar
+// as a C++ header. -j spreads the two rewrites over N threads (0 = all
+// cores); the output is the same for any N.
+// Build: g++ -O2 -std=c++17 -pthread grammar_pipeline.cpp -o grammar_pipeline
+// Usage: ./grammar_pipeline grammar.txt [--left-recursion out.txt] [--left-factoring out.txt]
+//                           [--first out.txt] [--follow out.txt] [--ll1 table.bin]
+//                           [--lr lalr|slr] [--emit-ll1 parser.h] [--emit-lr parser.h] [-j threads]
+
+struct PipelineOutputs {
+    string leftRecursion, leftFactoring, first, follow, ll1, lr, emitLL1, emitLR;
+};
+
+// Function to time one stage and report it
+template <typename Stage>
+auto timed(const char* name, Stage stage) {
+    auto start = chrono::steady_clock::now();
+    auto result = stage();
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    cout << "  " << name << ": " << ms << " ms\n";
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0]
+             << " grammar.txt [--left-recursion out] [--left-factoring out] [--first out] [--follow out]"
+             << " [--ll1 table] [--lr lalr|slr] [--emit-ll1 header] [--emit-lr header] [-j threads]" << endl;
+        return 1;
+    }
+
+    // Every option takes a value
+    static const char* options[] = {"--left-recursion", "--left-factoring", "--first", "--follow", "--ll1",
+                                    "--lr", "--emit-ll1", "--emit-lr", "-j"};
+    PipelineOutputs outputs;
+    unsigned threads = 1;
+    for (int i = 2; i < argc; i += 2) {
+        if (i + 1 == argc) {
+            bool known = false;
+            for (const char* option : options) known = known || strcmp(argv[i], option) == 0;
+            cerr << (known ? "Missing value for " : "Unknown option: ") << argv[i] << endl;
+            return 1;
+        }
+        if (strcmp(argv[i], "--left-recursion") == 0) {
+            outputs.leftRecursion = argv[i + 1];
+        } else if (strcmp(argv[i], "--left-factoring") == 0) {
+            outputs.leftFactoring = argv[i + 1];
+        } else if (strcmp(argv[i], "--first") == 0) {
+            outputs.first = argv[i + 1];
+        } else if (strcmp(argv[i], "--follow") == 0) {
+            outputs.follow = argv[i + 1];
+        } else if (strcmp(argv[i], "--ll1") == 0) {
+            outputs.ll1 = argv[i + 1];
+        } else if (strcmp(argv[i], "--lr") == 0 &&
+                   (strcmp(argv[i + 1], "lalr") == 0 || strcmp(argv[i + 1], "slr") == 0)) {
+            outputs.lr = argv[i + 1];
+        } else if (strcmp(argv[i], "--emit-ll1") == 0) {
+            outputs.emitLL1 = argv[i + 1];
+        } else if (strcmp(argv[i], "--emit-lr") == 0) {
+            outputs.emitLR = argv[i + 1];
+        } else if (strcmp(argv[i], "-j") == 0) {
+            threads = (unsigned)atoi(argv[i + 1]);
+        } else {
+            cerr << "Unknown option: " << argv[i] << endl;
+            return 1;
+        }
+    }
+
+    // The end marker is interned first so it is terminal 0 in every stage
+    Grammar input;
+    SymbolId endMarker = input.intern("$");
+    bool loaded = timed("load", [&]() { return input.load(argv[1]); });
+    if (!loaded) {
+        cerr << "Error opening file: " << argv[1] << endl;
+        return 1;
+    }
+
+    Grammar withoutRecursion;
+    if (!timed("left recursion", [&]() { return removeLeftRecursion(input, withoutRecursion, threads); })) {
+        cerr << "Left recursion removal gave up: substitution grew the grammar past "
+             << leftRecursionLimit(input) << " productions" << endl;
+        return 1;
+    }
+    Grammar factored = timed("left factoring", [&]() { return leftFactor(withoutRecursion, threads); });
+    FirstSets firstSets = timed("FIRST", [&]() { return computeAllFirst(factored); });
+    vector<TerminalSet> followSets = timed("FOLLOW", [&]() { return computeFollow(factored, firstSets, endMarker); });
+
+    // The parse table is only built when it is wanted
+    if (!outputs.ll1.empty() || !outputs.emitLL1.empty()) {
+        LL1Table table = timed("LL(1) table", [&]() { return LL1Table(factored, firstSets, followSets); });
+        CombTable comb = timed("compress", [&]() { return compressTable(table); });
+        cout << "  table: " << table.nonTerminalCount() * table.terminalCount() << " cells, "
+             << comb.check.size() << " after compression" << endl;
+        for (const LL1Conflict& conflict : table.conflicts()) {
+            cerr << "LL(1) conflict: " << describeConflict(factored, conflict) << endl;
+        }
+        bool written = outputs.ll1.empty() || writeLL1Table(outputs.ll1, factored, comb);
+        written = (outputs.emitLL1.empty() || emitLL1Parser(outputs.emitLL1, factored, table)) && written;
+        if (!written) {
+            cerr << "Error writing output files" << endl;
+            return 1;
+        }
+    }
+
+    if (!outputs.lr.empty() || !outputs.emitLR.empty()) {
+        bool slr = outputs.lr == "slr";
+        LRTable table = timed(slr ? "SLR(1) table" : "LALR(1) table", [&]() {
+            return buildLRTable(input, endMarker, slr);
+        });
+        cout << "  table: " << table.stateCount() << " states, " << table.conflicts().size() << " conflicts" << endl;
+        for (const LRConflict& conflict : table.conflicts()) {
+            cerr << "LR conflict: " << describeConflict(input, table, conflict) << endl;
+        }
+        if (!outputs.emitLR.empty() && !emitLRParser(outputs.emitLR, input, table)) {
+            cerr << "Error writing output files" << endl;
+            return 1;
+        }
+    }
+
+    // Write only what was asked for
+    bool ok = true;
+    if (!outputs.leftRecursion.empty()) ok = withoutRecursion.write(outputs.leftRecursion, true) && ok;
+    if (!outputs.leftFactoring.empty()) ok = factored.write(outputs.leftFactoring, true) && ok;
+    if (!outputs.first.empty()) ok = writeFirstSets(factored, firstSets, outputs.first) && ok;
+    if (!outputs.follow.empty()) ok = writeFollowSets(factored, followSets, outputs.follow) && ok;
+    if (!ok) {
+        cerr << "Error writing output files" << endl;
+        return 1;
+    }
+
+    cout << factored.nonTerminalCount() << " non-terminals, " << factored.productionCount() << " productions" << endl;
+    return 0;
+}
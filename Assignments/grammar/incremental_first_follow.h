@@ -0,0 +1,409 @@
+#ifndef INCREMENTAL_FIRST_FOLLOW_H
+#define INCREMENTAL_FIRST_FOLLOW_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "first_follow.h"
+#include "grammar.h"
+
+// FIRST and FOLLOW sets kept up to date while productions are added and
+// removed.
+//
+// An edit to A's productions can only change the sets that depend on A, so
+// each update works out that region and recomputes it from scratch, treating
+// every set outside it as fixed. Recomputing (rather than only adding to the
+// sets) handles removals too, where a set can shrink. Three regions are
+// recomputed in turn, each solved like the full analysis:
+//   nullable  A and the non-terminals with an all-non-terminal production
+//             that reaches A, solved by counting as in computeNullable
+//   FIRST     A, plus the users of a symbol whose nullability changed, and
+//             everything that can start with one of those
+//   FOLLOW    the symbols of the edited production and of the productions
+//             using a changed FIRST, and everything their FOLLOW flows into
+// The FIRST and FOLLOW regions are solved with propagateOverComponents over
+// the region only. For a grammar with thousands of rules an edit usually
+// touches a handful of sets.
+//
+// The symbol table is fixed at construction: an edit may only use existing
+// symbols, and a production's left side must already be a non-terminal. A
+// non-terminal whose last production is removed stays a non-terminal with
+// empty FIRST, so the dense numbering of the sets never changes.
+
+// Sizes of the regions recomputed by the last update
+struct IncrementalUpdateStats {
+    size_t nullable = 0;
+    size_t first = 0;
+    size_t follow = 0;
+};
+
+class IncrementalFirstFollow {
+public:
+    // endMarker is added to FOLLOW of the start symbol, the first non-terminal
+    IncrementalFirstFollow(const Grammar& grammar, SymbolId endMarker)
+        : symbols(grammar), productionsOf(grammar.nonTerminalCount()), usedIn(grammar.nonTerminalCount()),
+          flags(grammar.nonTerminalCount(), 0), localOf(grammar.nonTerminalCount(), -1) {
+        endTerminal = grammar.terminalIndex(endMarker);
+        for (uint32_t p = 0; p < grammar.productionCount(); ++p) {
+            SymbolSpan rhs = grammar.rhs(p);
+            link(grammar.nonTerminalIndex(grammar.lhs(p)), SymbolString(rhs.begin(), rhs.end()));
+        }
+        firstSets = computeAllFirst(grammar);
+        followSets = computeFollow(grammar, firstSets, endMarker);
+    }
+
+    // Function to add lhs -> rhs and update the sets; false if a symbol is unknown
+    // or lhs is a terminal
+    bool addProduction(SymbolId lhs, const SymbolString& rhs) {
+        if (!valid(lhs, rhs)) return false;
+        int a = symbols.nonTerminalIndex(lhs);
+        link(a, rhs);
+        update(a, rhs);
+        return true;
+    }
+
+    // Function to remove one production lhs -> rhs and update the sets; false if there is none
+    bool removeProduction(SymbolId lhs, const SymbolString& rhs) {
+        if (!valid(lhs, rhs)) return false;
+        int a = symbols.nonTerminalIndex(lhs);
+        std::vector<uint32_t>& own = productionsOf[a];
+        auto found = std::find_if(own.begin(), own.end(), [&](uint32_t p) { return productions[p].rhs == rhs; });
+        if (found == own.end()) return false;
+        uint32_t p = *found;
+        own.erase(found);
+        for (SymbolId sym : rhs) {
+            int b = symbols.nonTerminalIndex(sym);
+            if (b < 0) continue;
+            auto use = std::find(usedIn[b].begin(), usedIn[b].end(), p);
+            if (use == usedIn[b].end()) continue; // Second occurrence in the same production
+            *use = usedIn[b].back();
+            usedIn[b].pop_back();
+        }
+        productions[p].rhs.clear();
+        freeIds.push_back(p);
+        update(a, rhs);
+        return true;
+    }
+
+    const FirstSets& first() const { return firstSets; }
+    const std::vector<TerminalSet>& follow() const { return followSets; }
+    const IncrementalUpdateStats& lastUpdate() const { return stats; }
+
+    // The symbol table; names and dense indices of the sets come from here,
+    // but its productions are the ones the analysis started with
+    const Grammar& symbolTable() const { return symbols; }
+
+    // Function to build a Grammar with the current productions, each
+    // non-terminal's in the order they were added
+    Grammar toGrammar() const {
+        Grammar grammar(symbols);
+        grammar.clearProductions();
+        for (size_t a = 0; a < productionsOf.size(); ++a) {
+            grammar.addNonTerminal(symbols.nonTerminal(a)); // Even once its last production is gone
+            for (uint32_t p : productionsOf[a]) grammar.addProduction(symbols.nonTerminal(a), productions[p].rhs);
+        }
+        return grammar;
+    }
+
+private:
+    struct Production {
+        int lhs;
+        SymbolString rhs;
+    };
+
+    // Region membership bits in flags
+    enum : uint8_t { IN_NULLABLE = 1, NULLABLE_CHANGED = 2, IN_FIRST = 4, FIRST_CHANGED = 8, IN_FOLLOW = 16 };
+
+    Grammar symbols;
+    int endTerminal;
+    std::vector<Production> productions;            // By production ID; removed ones are recycled
+    std::vector<uint32_t> freeIds;
+    std::vector<std::vector<uint32_t>> productionsOf; // Per non-terminal, its productions in order
+    std::vector<std::vector<uint32_t>> usedIn;        // Per non-terminal, productions using it (once each)
+    FirstSets firstSets;
+    std::vector<TerminalSet> followSets;
+    IncrementalUpdateStats stats;
+
+    // Scratch for an update
+    std::vector<uint8_t> flags;                   // Per non-terminal
+    std::vector<int> localOf;                      // Per non-terminal, index within the current region
+    std::vector<uint32_t> pending;                 // Per production, symbols not yet known to vanish
+    std::vector<uint32_t> candidates;              // Productions that could make their left side nullable
+    std::vector<uint32_t> visited;                 // Per production, visitedStamp once walked
+    uint32_t visitedStamp = 0;
+    std::vector<int> nullableRegion, firstRegion, followRegion, worklist;
+    std::vector<std::vector<int>> edges;
+    std::vector<TerminalSet> sets;
+
+    bool valid(SymbolId lhs, const SymbolString& rhs) const {
+        if (lhs < 0 || (size_t)lhs >= symbols.symbolCount() || !symbols.isNonTerminal(lhs)) return false;
+        for (SymbolId sym : rhs) {
+            if (sym < 0 || (size_t)sym >= symbols.symbolCount()) return false;
+        }
+        return true;
+    }
+
+    int nonTerminalOf(SymbolId sym) const { return symbols.nonTerminalIndex(sym); }
+    bool allNonTerminals(const SymbolString& rhs) const {
+        for (SymbolId sym : rhs) {
+            if (nonTerminalOf(sym) < 0) return false;
+        }
+        return true;
+    }
+
+    void link(int a, const SymbolString& rhs) {
+        uint32_t p;
+        if (freeIds.empty()) {
+            p = (uint32_t)productions.size();
+            productions.push_back({a, rhs});
+        } else {
+            p = freeIds.back();
+            freeIds.pop_back();
+            productions[p] = {a, rhs};
+        }
+        productionsOf[a].push_back(p);
+        for (SymbolId sym : rhs) {
+            int b = nonTerminalOf(sym);
+            if (b >= 0 && (usedIn[b].empty() || usedIn[b].back() != p)) usedIn[b].push_back(p);
+        }
+    }
+
+    // Function to add b to a region list unless it carries the flag already
+    void enter(std::vector<int>& region, int b, uint8_t flag) {
+        if (flags[b] & flag) return;
+        flags[b] |= flag;
+        region.push_back(b);
+    }
+
+    // Function to recompute everything an edit to a's productions (rhs added or removed) can change
+    void update(int a, const SymbolString& rhs) {
+        nullableRegion.clear();
+        firstRegion.clear();
+        followRegion.clear();
+        updateNullable(a);
+        updateFirst(a);
+        updateFollow(rhs);
+        stats = {nullableRegion.size(), firstRegion.size(), followRegion.size()};
+        for (int b : nullableRegion) flags[b] = 0;
+        for (int b : firstRegion) flags[b] = 0;
+        for (int b : followRegion) flags[b] = 0;
+    }
+
+    void updateNullable(int a) {
+        // Only an all-non-terminal production can make its left side nullable
+        enter(nullableRegion, a, IN_NULLABLE);
+        for (size_t i = 0; i < nullableRegion.size(); ++i) {
+            for (uint32_t p : usedIn[nullableRegion[i]]) {
+                if (allNonTerminals(productions[p].rhs)) enter(nullableRegion, productions[p].lhs, IN_NULLABLE);
+            }
+        }
+
+        std::vector<bool> old;
+        for (int b : nullableRegion) {
+            old.push_back(firstSets.nullable[b]);
+            firstSets.nullable[b] = false;
+        }
+        if (pending.size() < productions.size()) pending.resize(productions.size());
+
+        // Count the symbols of each candidate production that may still vanish,
+        // then start from the candidates with none left
+        candidates.clear();
+        for (int b : nullableRegion) {
+            for (uint32_t p : productionsOf[b]) {
+                const SymbolString& body = productions[p].rhs;
+                if (!allNonTerminals(body)) continue;
+                pending[p] = 0;
+                for (SymbolId sym : body) pending[p] += !firstSets.nullable[nonTerminalOf(sym)];
+                candidates.push_back(p);
+            }
+        }
+        worklist.clear();
+        for (uint32_t p : candidates) {
+            int lhs = productions[p].lhs;
+            if (pending[p] == 0 && !firstSets.nullable[lhs]) {
+                firstSets.nullable[lhs] = true;
+                worklist.push_back(lhs);
+            }
+        }
+        while (!worklist.empty()) {
+            int c = worklist.back();
+            worklist.pop_back();
+            for (uint32_t p : usedIn[c]) {
+                int lhs = productions[p].lhs;
+                if (!(flags[lhs] & IN_NULLABLE) || firstSets.nullable[lhs] || !allNonTerminals(productions[p].rhs)) {
+                    continue;
+                }
+                for (SymbolId sym : productions[p].rhs) pending[p] -= nonTerminalOf(sym) == c;
+                if (pending[p] == 0) {
+                    firstSets.nullable[lhs] = true;
+                    worklist.push_back(lhs);
+                }
+            }
+        }
+
+        for (size_t i = 0; i < nullableRegion.size(); ++i) {
+            if (firstSets.nullable[nullableRegion[i]] != old[i]) flags[nullableRegion[i]] |= NULLABLE_CHANGED;
+        }
+    }
+
+    void updateFirst(int a) {
+        // Seeds: a, and every production whose first nullability change is at a reachable position
+        enter(firstRegion, a, IN_FIRST);
+        for (int b : nullableRegion) {
+            if (!(flags[b] & NULLABLE_CHANGED)) continue;
+            for (uint32_t p : usedIn[b]) {
+                const SymbolString& body = productions[p].rhs;
+                for (size_t i = 0; i < body.size(); ++i) {
+                    int c = nonTerminalOf(body[i]);
+                    if (c < 0) break;
+                    if (flags[c] & NULLABLE_CHANGED) {
+                        enter(firstRegion, productions[p].lhs, IN_FIRST);
+                        break;
+                    }
+                    if (!firstSets.nullable[c]) break;
+                }
+            }
+        }
+
+        // Everything that can start with a region member
+        for (size_t i = 0; i < firstRegion.size(); ++i) {
+            int b = firstRegion[i];
+            for (uint32_t p : usedIn[b]) {
+                for (SymbolId sym : productions[p].rhs) {
+                    int c = nonTerminalOf(sym);
+                    if (c == b) {
+                        enter(firstRegion, productions[p].lhs, IN_FIRST);
+                        break;
+                    }
+                    if (c < 0 || !firstSets.nullable[c]) break;
+                }
+            }
+        }
+
+        // Same as computeAllFirst over the region, with the sets outside it fixed
+        size_t terminalCount = symbols.terminalCount();
+        prepareRegion(firstRegion, terminalCount);
+        for (size_t i = 0; i < firstRegion.size(); ++i) {
+            for (uint32_t p : productionsOf[firstRegion[i]]) {
+                for (SymbolId sym : productions[p].rhs) {
+                    int c = nonTerminalOf(sym);
+                    if (c < 0) {
+                        sets[i].insert(symbols.terminalIndex(sym));
+                        break;
+                    }
+                    if (flags[c] & IN_FIRST) {
+                        edges[i].push_back(localOf[c]);
+                    } else {
+                        sets[i].unite(firstSets.terminals[c]);
+                    }
+                    if (!firstSets.nullable[c]) break;
+                }
+            }
+        }
+        propagateOverComponents(edges, sets);
+        for (size_t i = 0; i < firstRegion.size(); ++i) {
+            int b = firstRegion[i];
+            if (sets[i].words != firstSets.terminals[b].words) {
+                flags[b] |= FIRST_CHANGED;
+                firstSets.terminals[b] = sets[i];
+            }
+        }
+    }
+
+    void updateFollow(const SymbolString& rhs) {
+        // Seeds: the symbols of the edited production, and of every production
+        // using a non-terminal whose FIRST or nullability changed
+        for (SymbolId sym : rhs) {
+            int b = nonTerminalOf(sym);
+            if (b >= 0) enter(followRegion, b, IN_FOLLOW);
+        }
+        auto seedUsers = [&](int b) {
+            for (uint32_t p : usedIn[b]) {
+                for (SymbolId sym : productions[p].rhs) {
+                    int c = nonTerminalOf(sym);
+                    if (c >= 0) enter(followRegion, c, IN_FOLLOW);
+                }
+            }
+        };
+        for (int b : nullableRegion) {
+            if (flags[b] & NULLABLE_CHANGED) seedUsers(b);
+        }
+        for (int b : firstRegion) {
+            if (flags[b] & FIRST_CHANGED) seedUsers(b);
+        }
+
+        // Everything their FOLLOW flows into: B at the end of one of their productions
+        for (size_t i = 0; i < followRegion.size(); ++i) {
+            int b = followRegion[i];
+            for (uint32_t p : productionsOf[b]) {
+                const SymbolString& body = productions[p].rhs;
+                for (size_t j = body.size(); j-- > 0;) {
+                    int c = nonTerminalOf(body[j]);
+                    if (c < 0) break;
+                    enter(followRegion, c, IN_FOLLOW);
+                    if (!firstSets.nullable[c]) break;
+                }
+            }
+        }
+
+        // Same as computeFollow over the region, with the sets outside it fixed
+        size_t terminalCount = symbols.terminalCount();
+        prepareRegion(followRegion, terminalCount);
+        TerminalSet suffixFirst(terminalCount);
+        if (endTerminal >= 0 && !followRegion.empty() && (flags[0] & IN_FOLLOW)) sets[localOf[0]].insert(endTerminal);
+        if (visited.size() < productions.size()) visited.resize(productions.size(), 0);
+        visitedStamp++;
+        for (int b : followRegion) {
+            for (uint32_t p : usedIn[b]) {
+                if (visited[p] == visitedStamp) continue; // Each production is walked once
+                visited[p] = visitedStamp;
+                const SymbolString& body = productions[p].rhs;
+                int lhs = productions[p].lhs;
+                suffixFirst.clear();
+                bool suffixNullable = true;
+                for (size_t j = body.size(); j-- > 0;) {
+                    int c = nonTerminalOf(body[j]);
+                    if (c < 0) {
+                        suffixFirst.clear();
+                        suffixFirst.insert(symbols.terminalIndex(body[j]));
+                        suffixNullable = false;
+                        continue;
+                    }
+                    if (flags[c] & IN_FOLLOW) {
+                        TerminalSet& follow = sets[localOf[c]];
+                        follow.unite(suffixFirst);
+                        if (suffixNullable && lhs != c) {
+                            if (flags[lhs] & IN_FOLLOW) {
+                                edges[localOf[c]].push_back(localOf[lhs]);
+                            } else {
+                                follow.unite(followSets[lhs]);
+                            }
+                        }
+                    }
+                    if (firstSets.nullable[c]) {
+                        suffixFirst.unite(firstSets.terminals[c]);
+                    } else {
+                        suffixFirst = firstSets.terminals[c];
+                        suffixNullable = false;
+                    }
+                }
+            }
+        }
+        propagateOverComponents(edges, sets);
+        for (size_t i = 0; i < followRegion.size(); ++i) followSets[followRegion[i]] = sets[i];
+    }
+
+    // Function to number the region and give each member an empty set and no edges
+    void prepareRegion(const std::vector<int>& region, size_t terminalCount) {
+        edges.resize(region.size());
+        if (sets.size() < region.size()) sets.resize(region.size(), TerminalSet(terminalCount));
+        for (size_t i = 0; i < region.size(); ++i) {
+            localOf[region[i]] = (int)i;
+            edges[i].clear();
+            sets[i].clear();
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,115 @@
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "grammar_generator.h"
+#include "incremental_first_follow.h"
+
+using namespace std;
+
+// Randomized check of IncrementalFirstFollow: applies random production
+// additions and removals to generated grammars of every shape and after
+// every edit compares nullable, FIRST and FOLLOW of each non-terminal with
+// computeAllFirst and computeFollow run on the edited grammar from scratch.
+// Build: g++ -O2 -std=c++17 incremental_first_follow_check.cpp -o incremental_first_follow_check
+// Usage: ./incremental_first_follow_check [grammars] [edits per grammar] [seed]
+
+// Function to build the edited grammar for a full recompute, declaring every
+// non-terminal first so the dense numbering matches the incremental sets
+Grammar referenceGrammar(const Grammar& symbols, const vector<vector<SymbolString>>& rules) {
+    Grammar grammar(symbols);
+    grammar.clearProductions();
+    for (size_t a = 0; a < rules.size(); ++a) grammar.addNonTerminal(symbols.nonTerminal(a));
+    for (size_t a = 0; a < rules.size(); ++a) {
+        for (const SymbolString& rhs : rules[a]) grammar.addProduction(symbols.nonTerminal(a), rhs);
+    }
+    return grammar;
+}
+
+// Function to compare the incremental sets with a full recompute; prints the first difference
+bool matches(const IncrementalFirstFollow& sets, const vector<vector<SymbolString>>& rules, SymbolId endMarker,
+             size_t grammarNumber, size_t edit) {
+    const Grammar& symbols = sets.symbolTable();
+    Grammar reference = referenceGrammar(symbols, rules);
+    FirstSets first = computeAllFirst(reference);
+    vector<TerminalSet> follow = computeFollow(reference, first, endMarker);
+
+    for (size_t a = 0; a < rules.size(); ++a) {
+        const char* differs = nullptr;
+        if (sets.first().nullable[a] != first.nullable[a]) differs = "nullable";
+        else if (sets.first().terminals[a].words != first.terminals[a].words) differs = "FIRST";
+        else if (sets.follow()[a].words != follow[a].words) differs = "FOLLOW";
+        if (!differs) continue;
+        cout << "Grammar " << grammarNumber << ", edit " << edit << ": " << differs << "("
+             << symbols.name(symbols.nonTerminal(a)) << ") differs from a full recompute" << endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    size_t grammars = argc > 1 ? stoul(argv[1]) : 200;
+    size_t edits = argc > 2 ? stoul(argv[2]) : 200;
+    mt19937 rng(argc > 3 ? stoul(argv[3]) : 12345);
+    size_t shapeCount = sizeof(grammarShapes) / sizeof(grammarShapes[0]);
+
+    for (size_t g = 0; g < grammars; g++) {
+        // The end marker is interned first so it is terminal 0, as in first_follow_edit
+        Grammar input;
+        SymbolId endMarker = input.intern("$");
+        generateGrammar(input, grammarShapes[g % shapeCount].shape, 2 + rng() % 40, rng());
+        IncrementalFirstFollow sets(input, endMarker);
+        const Grammar& symbols = sets.symbolTable();
+
+        vector<vector<SymbolString>> rules(symbols.nonTerminalCount());
+        for (size_t a = 0; a < rules.size(); ++a) {
+            for (uint32_t p : symbols.productionsOf(a)) {
+                SymbolSpan rhs = symbols.rhs(p);
+                rules[a].emplace_back(rhs.begin(), rhs.end());
+            }
+        }
+        if (!matches(sets, rules, endMarker, g, 0)) return 1;
+
+        // Symbols an added production may use: every non-terminal and every terminal but $
+        vector<SymbolId> usable;
+        for (size_t a = 0; a < symbols.nonTerminalCount(); ++a) usable.push_back(symbols.nonTerminal(a));
+        for (size_t t = 1; t < symbols.terminalCount(); ++t) usable.push_back(symbols.terminal(t));
+
+        for (size_t e = 1; e <= edits; e++) {
+            size_t a = rng() % rules.size();
+            SymbolId lhs = symbols.nonTerminal(a);
+            if (rng() % 2 == 0 && !rules[a].empty()) {
+                // Remove one of A's productions; removing the last one leaves A with none
+                size_t victim = rng() % rules[a].size();
+                SymbolString rhs = rules[a][victim];
+                if (!sets.removeProduction(lhs, rhs)) {
+                    cout << "Grammar " << g << ", edit " << e << ": removing an existing production failed" << endl;
+                    return 1;
+                }
+                // The first equal production goes, as in removeProduction
+                for (size_t i = 0; i < rules[a].size(); ++i) {
+                    if (rules[a][i] != rhs) continue;
+                    rules[a].erase(rules[a].begin() + i);
+                    break;
+                }
+            } else {
+                // Add a short production, sometimes ε, sometimes a copy of one A already has
+                SymbolString rhs;
+                if (rng() % 8 == 0 && !rules[a].empty()) {
+                    rhs = rules[a][rng() % rules[a].size()];
+                } else {
+                    size_t length = rng() % 5;
+                    for (size_t s = 0; s < length; ++s) rhs.push_back(usable[rng() % usable.size()]);
+                }
+                if (!sets.addProduction(lhs, rhs)) {
+                    cout << "Grammar " << g << ", edit " << e << ": adding a production failed" << endl;
+                    return 1;
+                }
+                rules[a].push_back(rhs);
+            }
+            if (!matches(sets, rules, endMarker, g, e)) return 1;
+        }
+    }
+    cout << grammars * edits << " edits on " << grammars << " grammars match a full recompute" << endl;
+    return 0;
+}
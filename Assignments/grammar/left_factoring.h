@@ -0,0 +1,234 @@
+#ifndef LEFT_FACTORING_H
+#define LEFT_FACTORING_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "fresh_names.h"
+#include "grammar.h"
+#include "work_stealing.h"
+
+// Left factoring. The first production of a non-terminal collects every other
+// production that starts with the same symbol; their longest common prefix
+// is kept and the different suffixes move to a new non-terminal, which is
+// factored in turn. New non-terminals are processed breadth first and named
+// B, C, D, ..., Z, AA, AB, ..., skipping names already in the grammar. The
+// result shares the input's symbol numbering.
+//
+// The productions of each non-terminal are inserted once into a trie over
+// symbol IDs, so a common prefix is a chain of single-child nodes and every
+// new non-terminal sits at a branching node (two children, or a production
+// ending there). Factoring walks the trie instead of copying and erasing
+// right-hand sides: a new non-terminal is a trie node plus the order of the
+// productions below it, and each production is touched once per branching
+// node on its path. The order reproduces the collect-and-erase algorithm,
+// which lists a group as its first member followed by the rest in reverse.
+//
+// Factoring one non-terminal never looks at another, so each is a task on a
+// work-stealing pool and the new non-terminals it makes are spawned as
+// further tasks. Names are handed out afterwards, in breadth-first order.
+
+#define LEFT_FACTORING_NONE UINT32_MAX
+#define LEFT_FACTORING_NO_EDGE UINT64_MAX
+
+class LeftFactoring {
+public:
+    // threads == 0 uses every hardware thread; the result does not depend on it
+    explicit LeftFactoring(const Grammar& grammar, unsigned threads = 1)
+        : input(grammar), pool(threads), groups(pool.threadCount()) {
+        nextInGroup.assign(grammar.productionCount(), LEFT_FACTORING_NONE);
+        size_t symbols = 0;
+        for (uint32_t p = 0; p < grammar.productionCount(); ++p) symbols += grammar.rhs(p).size();
+        size_t slots = 16;
+        while (slots < symbols * 2) slots *= 2;
+        edgeKeys.assign(slots, LEFT_FACTORING_NO_EDGE);
+        edgeTargets.resize(slots);
+        for (size_t i = 0; i < grammar.nonTerminalCount(); ++i) {
+            roots.push_back(std::make_unique<Task>());
+            Task& root = *roots.back();
+            root.nonTerminal = grammar.nonTerminal(i);
+            root.node = newNode();
+            root.productions.reserve(grammar.productionsOf(i).size());
+            for (uint32_t p : grammar.productionsOf(i)) {
+                insert(root.node, p);
+                root.productions.push_back(p);
+            }
+        }
+    }
+
+    // Function to factor every non-terminal and return the new grammar
+    Grammar run() {
+        for (auto& root : roots) pool.add(root.get());
+        pool.run([&](Task* task, unsigned worker) { processLeftFactoring(*task, worker); });
+        return merge();
+    }
+
+private:
+    // Output rule: rhs[begin, end) of an input production, then the new
+    // non-terminal of children[child] unless child is -1
+    struct Rule {
+        uint32_t production;
+        uint32_t begin, end;
+        int32_t child;
+    };
+
+    // One non-terminal to factor. Its productions are the suffixes, from
+    // `depth` on, of the input productions listed, all of which pass through
+    // trie node `node`. Factoring fills in its rules and children; only the
+    // task itself touches them, so tasks run in any order on any thread.
+    struct Task {
+        SymbolId nonTerminal = NO_SYMBOL; // Named in merge() for new non-terminals
+        uint32_t node = 0;
+        uint32_t depth = 0;
+        std::vector<uint32_t> productions;
+        std::vector<Rule> rules;
+        std::vector<std::unique_ptr<Task>> children; // New non-terminals, in the order they were made
+    };
+
+    // Productions of one non-terminal sharing a first symbol, in the order they
+    // were collected: `first`, then the chain from `rest` through nextInGroup
+    struct Group {
+        uint32_t first;
+        uint32_t rest;
+        uint32_t node;  // Child reached by the shared symbol, LEFT_FACTORING_NONE for ε
+        uint32_t size;
+    };
+
+    const Grammar& input;
+    std::vector<std::unique_ptr<Task>> roots; // The input's non-terminals, in definition order
+    WorkStealingPool<Task*> pool;
+    std::vector<std::vector<Group>> groups;   // Scratch per worker
+    // Per input production, the next member of its current group. Tasks that
+    // can run at the same time never share a production.
+    std::vector<uint32_t> nextInGroup;
+
+    // Trie over symbol IDs. Edges live in an open-addressing table keyed by
+    // (node, symbol), sized up front for every symbol of the input, so it
+    // never grows. Only groupOf is written while factoring, each node by the
+    // one task owning its parent.
+    std::vector<uint32_t> endCount;   // Per node, productions ending there
+    std::vector<uint32_t> childCount; // Per node, outgoing edges
+    std::vector<uint32_t> groupOf;    // Per node, the group it was collected into
+    std::vector<uint64_t> edgeKeys;   // LEFT_FACTORING_NO_EDGE for a free slot
+    std::vector<uint32_t> edgeTargets;
+
+    static uint64_t edgeKey(uint32_t node, SymbolId symbol) { return (uint64_t)node << 32 | (uint32_t)symbol; }
+
+    // Function to find the slot of an edge, or the free slot where it belongs
+    size_t edgeSlot(uint64_t key) const {
+        size_t mask = edgeKeys.size() - 1;
+        size_t slot = (key * 0x9E3779B97F4A7C15ull) >> 32 & mask;
+        while (edgeKeys[slot] != key && edgeKeys[slot] != LEFT_FACTORING_NO_EDGE) slot = (slot + 1) & mask;
+        return slot;
+    }
+
+    uint32_t newNode() {
+        endCount.push_back(0);
+        childCount.push_back(0);
+        groupOf.push_back(LEFT_FACTORING_NONE);
+        return (uint32_t)endCount.size() - 1;
+    }
+
+    void insert(uint32_t node, uint32_t production) {
+        for (SymbolId symbol : input.rhs(production)) {
+            uint64_t key = edgeKey(node, symbol);
+            size_t slot = edgeSlot(key);
+            if (edgeKeys[slot] == LEFT_FACTORING_NO_EDGE) {
+                childCount[node]++;
+                edgeKeys[slot] = key;
+                edgeTargets[slot] = newNode();
+            }
+            node = edgeTargets[slot];
+        }
+        endCount[node]++;
+    }
+
+    uint32_t child(uint32_t node, SymbolId symbol) const { return edgeTargets[edgeSlot(edgeKey(node, symbol))]; }
+
+    void processLeftFactoring(Task& task, unsigned worker) {
+        if (task.productions.size() <= 1) {
+            for (uint32_t p : task.productions) task.rules.push_back({p, task.depth, (uint32_t)input.rhs(p).size(), -1});
+            return;
+        }
+
+        // Collect groups by next symbol, in order of first appearance; each ε is its own group
+        std::vector<Group>& collected = groups[worker];
+        collected.clear();
+        for (uint32_t p : task.productions) {
+            SymbolSpan rhs = input.rhs(p);
+            if (rhs.size() == task.depth) {
+                collected.push_back({p, LEFT_FACTORING_NONE, LEFT_FACTORING_NONE, 1});
+                continue;
+            }
+            uint32_t node = child(task.node, rhs[task.depth]);
+            if (groupOf[node] == LEFT_FACTORING_NONE) {
+                groupOf[node] = (uint32_t)collected.size();
+                collected.push_back({p, LEFT_FACTORING_NONE, node, 1});
+            } else {
+                Group& group = collected[groupOf[node]];
+                nextInGroup[p] = group.rest;
+                group.rest = p;
+                group.size++;
+            }
+        }
+
+        task.rules.reserve(collected.size());
+        for (const Group& group : collected) {
+            SymbolSpan rhs = input.rhs(group.first);
+            if (group.size == 1) {
+                task.rules.push_back({group.first, task.depth, (uint32_t)rhs.size(), -1});
+                continue;
+            }
+
+            // Follow the chain of single-child nodes to where the group branches
+            uint32_t node = group.node, depth = task.depth + 1;
+            while (endCount[node] == 0 && childCount[node] == 1) node = child(node, rhs[depth++]);
+
+            task.rules.push_back({group.first, task.depth, depth, (int32_t)task.children.size()});
+            task.children.push_back(std::make_unique<Task>());
+            Task& next = *task.children.back();
+            next.node = node;
+            next.depth = depth;
+            next.productions.reserve(group.size);
+            next.productions.push_back(group.first);
+            for (uint32_t p = group.rest; p != LEFT_FACTORING_NONE; p = nextInGroup[p]) next.productions.push_back(p);
+        }
+        std::vector<uint32_t>().swap(task.productions);
+        for (auto& next : task.children) pool.spawn(worker, next.get());
+    }
+
+    // Function to name the new non-terminals and build the grammar. Walking the
+    // task tree breadth first, children in the order they were made, visits
+    // the non-terminals in the order a single FIFO queue factors them, so
+    // names and productions come out the same for any number of threads.
+    Grammar merge() {
+        Grammar output(input);
+        output.clearProductions();
+        FreshNames names(output);
+        std::vector<Task*> order;
+        for (auto& root : roots) order.push_back(root.get());
+        for (size_t i = 0; i < order.size(); ++i) {
+            for (auto& next : order[i]->children) {
+                next->nonTerminal = names.letter();
+                order.push_back(next.get());
+            }
+        }
+
+        SymbolString rhs;
+        for (Task* task : order) {
+            output.addNonTerminal(task->nonTerminal); // Kept even if the input gave it no productions
+            for (const Rule& rule : task->rules) {
+                SymbolSpan symbols = input.rhs(rule.production);
+                rhs.assign(symbols.begin() + rule.begin, symbols.begin() + rule.end);
+                if (rule.child >= 0) rhs.push_back(task->children[rule.child]->nonTerminal);
+                output.addProduction(task->nonTerminal, rhs);
+            }
+        }
+        return output;
+    }
+};
+
+// Function to left-factor a grammar
+inline Grammar leftFactor(const Grammar& grammar, unsigned threads = 1) { return LeftFactoring(grammar, threads).run(); }
+
+#endif
@@ -0,0 +1,241 @@
+#ifndef LEFT_RECURSION_H
+#define LEFT_RECURSION_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+#include "first_follow.h"
+#include "fresh_names.h"
+#include "grammar.h"
+#include "work_stealing.h"
+
+// Removal of left recursion (the textbook algorithm: order the non-terminals,
+// substitute earlier ones at the front of later ones, then remove immediate
+// recursion A -> Aα | β as A -> βA', A' -> αA' | ε), applied only inside
+// the cycles of the left-corner graph. Non-terminals are ordered by name; A'
+// becomes A'2, A'3, ... when the name is already taken. The result shares
+// the input's symbol numbering and keeps the input's order of definition,
+// each A' right after its A.
+//
+// Components are independent, so each is a task on a work-stealing pool.
+// While they run, A' is a placeholder ID past the end of the symbol table;
+// the real names are handed out afterwards in component order, as a serial
+// run would, so the result does not depend on the number of threads.
+//
+// Substitution inside a large left cycle can multiply the productions
+// exponentially. The productions are counted as they are made, and removal
+// gives up and reports failure once they pass a limit: by default
+// LEFT_RECURSION_GROWTH_LIMIT times the input's productions, and at least
+// LEFT_RECURSION_MIN_LIMIT.
+
+#define LEFT_RECURSION_GROWTH_LIMIT 16
+#define LEFT_RECURSION_MIN_LIMIT 100000
+
+// Function to get the default production limit for removing left recursion from grammar
+inline size_t leftRecursionLimit(const Grammar& grammar) {
+    return std::max<size_t>(LEFT_RECURSION_MIN_LIMIT, grammar.productionCount() * LEFT_RECURSION_GROWTH_LIMIT);
+}
+
+// Productions made so far by all tasks, against the limit
+struct LeftRecursionBudget {
+    std::atomic<size_t> productions;
+    size_t limit;
+
+    // Function to account for `added` more productions; false once over the limit
+    bool grow(size_t added) { return productions.fetch_add(added) + added <= limit; }
+    bool exceeded() const { return productions.load() > limit; }
+};
+
+// Function to remove immediate left recursion for a single non-terminal
+// using newNonTerminal as A'; rules and primeOf must already cover it
+inline void removeImmediateLeftRecursion(SymbolId nonTerminal, SymbolId newNonTerminal,
+                                         std::vector<std::vector<SymbolString>>& rules,
+                                         std::vector<SymbolId>& primeOf, LeftRecursionBudget& budget) {
+    std::vector<SymbolString> recursive, nonRecursive;
+
+    // Separate recursive and non-recursive productions
+    for (const auto& rhs : rules[nonTerminal]) {
+        if (!rhs.empty() && rhs[0] == nonTerminal) {
+            recursive.push_back(SymbolString(rhs.begin() + 1, rhs.end())); // Get α in A -> Aα
+        } else {
+            nonRecursive.push_back(rhs);
+        }
+    }
+
+    // If no left recursion, return
+    if (recursive.empty()) return;
+
+    std::vector<SymbolString> newRhs, updatedRhs;
+
+    // For non-recursive productions: A -> β becomes A -> βA'
+    for (auto beta : nonRecursive) {
+        beta.push_back(newNonTerminal);
+        updatedRhs.push_back(beta);
+    }
+
+    // For recursive productions: A -> Aα becomes A' -> αA' | ε
+    for (auto alpha : recursive) {
+        if (alpha.empty()) continue; // Skip if α is empty
+        alpha.push_back(newNonTerminal);
+        newRhs.push_back(alpha);
+    }
+    newRhs.push_back(SymbolString()); // Add epsilon production
+
+    rules[nonTerminal] = updatedRhs;
+    rules[newNonTerminal] = newRhs;
+    primeOf[nonTerminal] = newNonTerminal;
+    budget.grow(1); // The ε production of A'
+}
+
+// Cyclic components of the left-corner graph (A -> B when a production of A
+// starts with B), in the order Tarjan's algorithm finishes them
+struct LeftCornerCycles {
+    std::vector<std::vector<SymbolId>> members; // Per component, ordered by name
+    std::vector<int> componentOf;                // Per symbol, its component or -1
+    std::vector<int> rank;                       // Per symbol, its position in members
+};
+
+// Function to find the components that can be left-recursive: those with
+// more than one member, or one that starts one of its own productions
+inline LeftCornerCycles findLeftCornerCycles(const Grammar& grammar) {
+    std::vector<std::vector<int>> leftCorners(grammar.nonTerminalCount());
+    for (uint32_t p = 0; p < grammar.productionCount(); ++p) {
+        SymbolSpan rhs = grammar.rhs(p);
+        if (!rhs.empty() && grammar.isNonTerminal(rhs[0])) {
+            leftCorners[grammar.nonTerminalIndex(grammar.lhs(p))].push_back(grammar.nonTerminalIndex(rhs[0]));
+        }
+    }
+
+    LeftCornerCycles cycles;
+    cycles.componentOf.assign(grammar.symbolCount(), -1);
+    cycles.rank.assign(grammar.symbolCount(), -1);
+    forEachComponent(leftCorners, [&](const std::vector<int>& component, const std::vector<int>&) {
+        if (component.size() == 1) {
+            const std::vector<int>& corners = leftCorners[component[0]];
+            if (std::find(corners.begin(), corners.end(), component[0]) == corners.end()) return;
+        }
+        std::vector<SymbolId> members;
+        for (int m : component) members.push_back(grammar.nonTerminal(m));
+        std::sort(members.begin(), members.end(), [&](SymbolId a, SymbolId b) {
+            return grammar.name(a) < grammar.name(b);
+        });
+        for (size_t i = 0; i < members.size(); ++i) {
+            cycles.componentOf[members[i]] = (int)cycles.members.size();
+            cycles.rank[members[i]] = (int)i;
+        }
+        cycles.members.push_back(members);
+    });
+    return cycles;
+}
+
+// Function to substitute the productions of earlier members of component c at
+// the front of member i's productions (A_i -> A_j γ becomes A_i -> β γ for
+// j < i). Once A_j is done its productions only start with later members, so
+// taking the earliest member still at a front each time visits the same j as
+// the textbook loop over every j < i, skipping those with nothing to replace.
+// Returns false, leaving the rules half done, once the budget runs out.
+inline bool substituteEarlierMembers(const LeftCornerCycles& cycles, size_t c, size_t i,
+                                     std::vector<std::vector<SymbolString>>& rules, LeftRecursionBudget& budget) {
+    const std::vector<SymbolId>& members = cycles.members[c];
+    SymbolId A_i = members[i];
+    for (;;) {
+        int earliest = (int)i;
+        for (const auto& rhs : rules[A_i]) {
+            if (rhs.empty() || (size_t)rhs[0] >= cycles.componentOf.size()) continue; // ε, or an A' placeholder
+            if (cycles.componentOf[rhs[0]] == (int)c) earliest = std::min(earliest, cycles.rank[rhs[0]]);
+        }
+        if (earliest == (int)i) return true;
+
+        // Every production starting with A_j becomes one per production of A_j
+        SymbolId A_j = members[earliest];
+        size_t replaced = 0;
+        for (const auto& rhs : rules[A_i]) replaced += !rhs.empty() && rhs[0] == A_j;
+        size_t alternatives = rules[A_j].size();
+        if (alternatives > 1 && !budget.grow(replaced * (alternatives - 1))) return false;
+
+        std::vector<SymbolString> newRhs;
+        for (const auto& rhs : rules[A_i]) {
+            if (!rhs.empty() && rhs[0] == A_j) {
+                for (const auto& beta : rules[A_j]) {
+                    SymbolString newRule = beta;
+                    newRule.insert(newRule.end(), rhs.begin() + 1, rhs.end());
+                    newRhs.push_back(newRule);
+                }
+            } else {
+                newRhs.push_back(rhs);
+            }
+        }
+        rules[A_i] = newRhs;
+    }
+}
+
+// Function to remove all left recursion from a grammar into output.
+// Only non-terminals on a cycle of the left-corner graph can be
+// left-recursive, and substitution never has to leave their strongly
+// connected component: anything outside it cannot lead back. So the
+// algorithm runs per cyclic component and every other non-terminal keeps its
+// productions untouched. threads == 0 uses every hardware thread.
+// Returns false, leaving output unchanged, if the grammar would grow past
+// maxProductions productions (0 for the default limit).
+inline bool removeLeftRecursion(const Grammar& grammar, Grammar& output, unsigned threads = 1,
+                                size_t maxProductions = 0) {
+    size_t symbolCount = grammar.symbolCount();
+    if (maxProductions == 0) maxProductions = leftRecursionLimit(grammar);
+    LeftRecursionBudget budget{{grammar.productionCount()}, maxProductions};
+
+    // A' of the non-terminal with dense index n is the placeholder symbolCount + n
+    std::vector<std::vector<SymbolString>> rules(symbolCount + grammar.nonTerminalCount());
+    std::vector<SymbolId> primeOf(rules.size(), NO_SYMBOL);
+    for (size_t i = 0; i < grammar.nonTerminalCount(); ++i) {
+        SymbolId nt = grammar.nonTerminal(i);
+        for (uint32_t p : grammar.productionsOf(i)) {
+            SymbolSpan rhs = grammar.rhs(p);
+            rules[nt].push_back(SymbolString(rhs.begin(), rhs.end()));
+        }
+    }
+    LeftCornerCycles cycles = findLeftCornerCycles(grammar);
+
+    // Each task touches only its own members' rules, primes and placeholders
+    WorkStealingPool<size_t> pool(threads);
+    for (size_t c = 0; c < cycles.members.size(); ++c) pool.add(c);
+    pool.run([&](size_t c, unsigned) {
+        const std::vector<SymbolId>& members = cycles.members[c];
+        for (size_t i = 0; i < members.size() && !budget.exceeded(); ++i) {
+            // Handle indirect recursion, then remove immediate left recursion for A_i
+            if (!substituteEarlierMembers(cycles, c, i, rules, budget)) return;
+            SymbolId placeholder = (SymbolId)(symbolCount + grammar.nonTerminalIndex(members[i]));
+            removeImmediateLeftRecursion(members[i], placeholder, rules, primeOf, budget);
+        }
+    });
+    if (budget.exceeded()) return false;
+
+    // Name the primes in component order, as a single thread would have
+    output = grammar;
+    FreshNames names(output);
+    std::vector<SymbolId> nameOf(rules.size());
+    for (size_t id = 0; id < symbolCount; ++id) nameOf[id] = (SymbolId)id;
+    for (const std::vector<SymbolId>& members : cycles.members) {
+        for (SymbolId nt : members) {
+            if (primeOf[nt] != NO_SYMBOL) nameOf[primeOf[nt]] = names.prime(nt);
+        }
+    }
+
+    // Rebuild the productions. A non-terminal whose every production was left
+    // recursive (A -> A α with no β) derives nothing and stays without any.
+    output.clearProductions();
+    SymbolString renamed;
+    for (size_t i = 0; i < grammar.nonTerminalCount(); ++i) {
+        for (SymbolId nt = grammar.nonTerminal(i); nt != NO_SYMBOL; nt = primeOf[nt]) {
+            output.addNonTerminal(nameOf[nt]);
+            for (const auto& rhs : rules[nt]) {
+                renamed.clear();
+                for (SymbolId symbol : rhs) renamed.push_back(nameOf[symbol]);
+                output.addProduction(nameOf[nt], renamed);
+            }
+        }
+    }
+    return true;
+}
+
+#endif
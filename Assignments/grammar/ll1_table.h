@@ -0,0 +1,388 @@
+#ifndef LL1_TABLE_H
+#define LL1_TABLE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+#include "first_follow.h"
+
+// LL(1) parse table built from FIRST and FOLLOW.
+//
+// LL1Table is the dense non-terminal x terminal matrix of production IDs.
+// A cell claimed by two productions is a conflict; the lower production ID
+// keeps the cell and the clash is recorded so it can be reported.
+//
+// CombTable is the same table in row-displacement form: every row is slid to
+// an offset (base) where its entries land on free slots of one shared array,
+// and a check array records which row owns each slot. A lookup is two loads
+// and a compare, and the size tracks the number of filled cells rather than
+// rows x columns, which matters for large, sparse grammars.
+//
+// Table file layout (little-endian, every array 4-byte aligned):
+//   LL1TableHeader
+//   int32_t base[nonTerminalCount]
+//   int32_t check[combSize]              owning non-terminal, -1 if free
+//   int32_t next[combSize]               production ID
+//   int32_t lhs[productionCount]         non-terminal index
+//   uint32_t rhsStart[productionCount + 1]
+//   int32_t rhs[rhsSize]                 terminal t as t, non-terminal n as -(n + 1)
+//   uint32_t nameStart[nonTerminalCount + terminalCount + 1]
+//   char names[namesSize]                non-terminal names, then terminal names
+// LL1TableFile maps the file (or attaches to an image in memory) and serves
+// lookups from it directly, so a parser starts without parsing the grammar or
+// rebuilding anything.
+
+#define LL1_NO_PRODUCTION (-1)
+#define LL1_TABLE_MAGIC 0x5431314Cu  // "LL1T"
+#define LL1_TABLE_VERSION 1
+
+struct LL1Conflict {
+    int nonTerminal;   // Dense non-terminal index
+    int terminal;      // Dense terminal index
+    uint32_t chosen;   // Production that keeps the cell
+    uint32_t rejected; // Production that also wanted it
+};
+
+class LL1Table {
+public:
+    LL1Table(const Grammar& grammar, const FirstSets& firstSets, const std::vector<TerminalSet>& followSets)
+        : rows(grammar.nonTerminalCount()), columns(grammar.terminalCount()),
+          cells(rows * columns, LL1_NO_PRODUCTION) {
+        TerminalSet first(columns);
+        for (uint32_t p = 0; p < grammar.productionCount(); ++p) {
+            int lhs = grammar.nonTerminalIndex(grammar.lhs(p));
+
+            // FIRST of the right-hand side, and whether all of it can vanish
+            first.clear();
+            bool nullable = true;
+            for (SymbolId sym : grammar.rhs(p)) {
+                int symIndex = grammar.nonTerminalIndex(sym);
+                if (symIndex < 0) {
+                    first.insert(grammar.terminalIndex(sym));
+                    nullable = false;
+                    break;
+                }
+                first.unite(firstSets.terminals[symIndex]);
+                if (!firstSets.nullable[symIndex]) {
+                    nullable = false;
+                    break;
+                }
+            }
+
+            // A -> α goes under every a in FIRST(α), and under FOLLOW(A) if α can vanish
+            first.forEach([&](int terminal) { claim(lhs, terminal, p); });
+            if (nullable) followSets[lhs].forEach([&](int terminal) { claim(lhs, terminal, p); });
+        }
+    }
+
+    size_t nonTerminalCount() const { return rows; }
+    size_t terminalCount() const { return columns; }
+    int32_t at(int nonTerminal, int terminal) const { return cells[(size_t)nonTerminal * columns + terminal]; }
+    const std::vector<LL1Conflict>& conflicts() const { return conflictList; }
+    bool isLL1() const { return conflictList.empty(); }
+
+private:
+    size_t rows, columns;
+    std::vector<int32_t> cells;
+    std::vector<LL1Conflict> conflictList;
+
+    void claim(int nonTerminal, int terminal, uint32_t production) {
+        int32_t& cell = cells[(size_t)nonTerminal * columns + terminal];
+        if (cell == LL1_NO_PRODUCTION) {
+            cell = production;
+        } else if (cell != (int32_t)production) {
+            conflictList.push_back(LL1Conflict{nonTerminal, terminal, (uint32_t)cell, production});
+        }
+    }
+};
+
+// Function to describe a conflict, e.g. "E on id: E -> id | E -> id + E"
+inline std::string describeConflict(const Grammar& grammar, const LL1Conflict& conflict) {
+    std::string lhs(grammar.name(grammar.nonTerminal(conflict.nonTerminal)));
+    std::string text = lhs + " on " + std::string(grammar.name(grammar.terminal(conflict.terminal))) + ": ";
+    text += lhs + " -> " + grammar.formatRhs(conflict.chosen) + " | ";
+    text += lhs + " -> " + grammar.formatRhs(conflict.rejected);
+    return text;
+}
+
+// Row-displacement form of an LL(1) table
+struct CombTable {
+    std::vector<int32_t> base;   // Per non-terminal, offset of its row
+    std::vector<int32_t> check;  // Owning non-terminal of each slot, -1 if free
+    std::vector<int32_t> next;   // Production ID of each slot
+    size_t columns = 0;
+
+    int32_t at(int nonTerminal, int terminal) const {
+        size_t slot = (size_t)base[nonTerminal] + terminal;
+        return check[slot] == nonTerminal ? next[slot] : LL1_NO_PRODUCTION;
+    }
+};
+
+// Function to pack a dense table into a comb vector. Rows go in from the
+// fullest to the emptiest, each at the first offset where all its entries
+// land on free slots. The array is padded by one row width so that any
+// base + terminal stays in range without a bounds check.
+inline CombTable compressTable(const LL1Table& table) {
+    size_t rows = table.nonTerminalCount(), columns = table.terminalCount();
+    std::vector<std::vector<int>> filled(rows);
+    for (size_t nt = 0; nt < rows; ++nt) {
+        for (size_t t = 0; t < columns; ++t) {
+            if (table.at(nt, t) != LL1_NO_PRODUCTION) filled[nt].push_back(t);
+        }
+    }
+    std::vector<size_t> order(rows);
+    for (size_t i = 0; i < rows; ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return filled[a].size() > filled[b].size(); });
+
+    CombTable comb;
+    comb.columns = columns;
+    comb.base.assign(rows, 0);
+    std::vector<bool> used;
+    size_t firstFree = 0; // Slots below this are all taken
+    for (size_t nt : order) {
+        if (filled[nt].empty()) continue; // base 0; check never names this row
+        size_t offset = firstFree >= (size_t)filled[nt][0] ? firstFree - filled[nt][0] : 0;
+        while (true) {
+            bool fits = true;
+            for (int t : filled[nt]) {
+                if (offset + t < used.size() && used[offset + t]) {
+                    fits = false;
+                    break;
+                }
+            }
+            if (fits) break;
+            offset++;
+        }
+        comb.base[nt] = (int32_t)offset;
+        size_t end = offset + filled[nt].back() + 1;
+        if (used.size() < end) {
+            used.resize(end, false);
+            comb.check.resize(end, -1);
+            comb.next.resize(end, LL1_NO_PRODUCTION);
+        }
+        for (int t : filled[nt]) {
+            used[offset + t] = true;
+            comb.check[offset + t] = (int32_t)nt;
+            comb.next[offset + t] = table.at(nt, t);
+        }
+        while (firstFree < used.size() && used[firstFree]) firstFree++;
+    }
+
+    size_t maxBase = 0;
+    for (int32_t b : comb.base) maxBase = std::max(maxBase, (size_t)b);
+    comb.check.resize(maxBase + columns, -1);
+    comb.next.resize(maxBase + columns, LL1_NO_PRODUCTION);
+    return comb;
+}
+
+struct LL1TableHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t nonTerminalCount;
+    uint32_t terminalCount;
+    uint32_t productionCount;
+    uint32_t combSize;
+    uint32_t rhsSize;
+    uint32_t namesSize;
+};
+
+// Function to lay out a comb table and the productions it refers to as a table file image
+inline std::string serializeLL1Table(const Grammar& grammar, const CombTable& comb) {
+    uint32_t rows = grammar.nonTerminalCount(), columns = grammar.terminalCount();
+    std::vector<int32_t> lhs, rhs;
+    std::vector<uint32_t> rhsStart{0}, nameStart{0};
+    std::string names;
+    for (uint32_t p = 0; p < grammar.productionCount(); ++p) {
+        lhs.push_back(grammar.nonTerminalIndex(grammar.lhs(p)));
+        for (SymbolId sym : grammar.rhs(p)) {
+            int nt = grammar.nonTerminalIndex(sym);
+            rhs.push_back(nt >= 0 ? -(nt + 1) : grammar.terminalIndex(sym));
+        }
+        rhsStart.push_back(rhs.size());
+    }
+    for (uint32_t i = 0; i < rows; ++i) {
+        names += grammar.name(grammar.nonTerminal(i));
+        nameStart.push_back(names.size());
+    }
+    for (uint32_t i = 0; i < columns; ++i) {
+        names += grammar.name(grammar.terminal(i));
+        nameStart.push_back(names.size());
+    }
+
+    LL1TableHeader header{LL1_TABLE_MAGIC, LL1_TABLE_VERSION, rows, columns, (uint32_t)lhs.size(),
+                          (uint32_t)comb.check.size(), (uint32_t)rhs.size(), (uint32_t)names.size()};
+    std::string blob((const char*)&header, sizeof(header));
+    auto append = [&](const void* data, size_t size) { blob.append((const char*)data, size); };
+    append(comb.base.data(), comb.base.size() * sizeof(int32_t));
+    append(comb.check.data(), comb.check.size() * sizeof(int32_t));
+    append(comb.next.data(), comb.next.size() * sizeof(int32_t));
+    append(lhs.data(), lhs.size() * sizeof(int32_t));
+    append(rhsStart.data(), rhsStart.size() * sizeof(uint32_t));
+    append(rhs.data(), rhs.size() * sizeof(int32_t));
+    append(nameStart.data(), nameStart.size() * sizeof(uint32_t));
+    blob += names;
+    return blob;
+}
+
+// Function to write a comb table and the productions it refers to
+inline bool writeLL1Table(const std::string& filename, const Grammar& grammar, const CombTable& comb) {
+    std::string blob = serializeLL1Table(grammar, comb);
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) return false;
+    file.write(blob.data(), blob.size());
+    return (bool)file;
+}
+
+// Read-only view of a table file, served straight from the mapping
+class LL1TableFile {
+public:
+    LL1TableFile() = default;
+    LL1TableFile(const LL1TableFile&) = delete;
+    LL1TableFile& operator=(const LL1TableFile&) = delete;
+
+    ~LL1TableFile() { close(); }
+
+    // Function to map a table file and check its layout; an open file is closed first
+    bool open(const char* path) {
+        close();
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        bool ok = fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(LL1TableHeader);
+        if (ok) {
+            mappedSize = (size_t)st.st_size;
+            void* view = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+            ok = view != MAP_FAILED;
+            if (ok) mapped = (char*)view;
+        }
+        ::close(fd);
+        if (ok && attach(mapped, mappedSize)) return true;
+        close();
+        return false;
+    }
+
+    // Function to use a table image already in memory, e.g. from serializeLL1Table();
+    // the image must stay alive and 4-byte aligned while the table is in use.
+    // Every count, offset and index in the image is checked before it is used, so
+    // a truncated or corrupt image is refused and leaves the table empty.
+    bool attach(const char* image, size_t size) {
+        rows = columns = productions = 0;
+        if (size < sizeof(LL1TableHeader) || (uintptr_t)image % alignof(int32_t) != 0) return false;
+        const LL1TableHeader* header = (const LL1TableHeader*)image;
+        if (header->magic != LL1_TABLE_MAGIC || header->version != LL1_TABLE_VERSION) return false;
+        uint32_t rowCount = header->nonTerminalCount, columnCount = header->terminalCount;
+        uint32_t productionCount = header->productionCount, combSize = header->combSize;
+        if (rowCount == 0 || rowCount > INT32_MAX || columnCount > INT32_MAX || productionCount > INT32_MAX) {
+            return false;
+        }
+        size_t names = (size_t)rowCount + columnCount;
+        size_t expected = sizeof(LL1TableHeader) +
+                          sizeof(int32_t) * ((size_t)rowCount + 2 * (size_t)combSize + productionCount +
+                                             (productionCount + 1) + header->rhsSize + (names + 1)) +
+                          header->namesSize;
+        if (expected != size) return false;
+
+        const int32_t* baseOf = (const int32_t*)(image + sizeof(LL1TableHeader));
+        const int32_t* checkOf = baseOf + rowCount;
+        const int32_t* nextOf = checkOf + combSize;
+        const int32_t* lhsTable = nextOf + combSize;
+        const uint32_t* rhsStarts = (const uint32_t*)(lhsTable + productionCount);
+        const int32_t* rhsTable = (const int32_t*)(rhsStarts + productionCount + 1);
+        const uint32_t* nameStarts = (const uint32_t*)(rhsTable + header->rhsSize);
+
+        // Every row's slots lie inside the comb, and an owned slot names a real production
+        for (uint32_t nt = 0; nt < rowCount; ++nt) {
+            if (baseOf[nt] < 0 || (size_t)baseOf[nt] + columnCount > combSize) return false;
+        }
+        for (uint32_t slot = 0; slot < combSize; ++slot) {
+            if (checkOf[slot] < -1 || checkOf[slot] >= (int64_t)rowCount) return false;
+            if (checkOf[slot] >= 0 && (nextOf[slot] < 0 || (uint32_t)nextOf[slot] >= productionCount)) return false;
+        }
+
+        // Productions have a real left side, and their right sides run through rhs in order
+        if (!ascending(rhsStarts, productionCount, header->rhsSize)) return false;
+        for (uint32_t p = 0; p < productionCount; ++p) {
+            if (lhsTable[p] < 0 || lhsTable[p] >= (int64_t)rowCount) return false;
+        }
+        for (uint32_t i = 0; i < header->rhsSize; ++i) {
+            if (rhsTable[i] < -(int64_t)rowCount || rhsTable[i] >= (int64_t)columnCount) return false;
+        }
+        if (!ascending(nameStarts, names, header->namesSize)) return false;
+
+        rows = rowCount;
+        columns = columnCount;
+        productions = productionCount;
+        base = baseOf;
+        check = checkOf;
+        next = nextOf;
+        lhsOf = lhsTable;
+        rhsStart = rhsStarts;
+        rhsSymbols = rhsTable;
+        nameStart = nameStarts;
+        namePool = (const char*)(nameStarts + names + 1);
+        return true;
+    }
+
+    // Function to unmap the file; the table is empty afterwards
+    void close() {
+        if (mapped) munmap(mapped, mappedSize);
+        mapped = nullptr;
+        mappedSize = 0;
+        rows = columns = productions = 0;
+    }
+
+    size_t nonTerminalCount() const { return rows; }
+    size_t terminalCount() const { return columns; }
+    size_t productionCount() const { return productions; }
+
+    // Function to look up the production for a non-terminal and a lookahead terminal
+    int32_t at(int nonTerminal, int terminal) const {
+        size_t slot = (size_t)base[nonTerminal] + terminal;
+        return check[slot] == nonTerminal ? next[slot] : LL1_NO_PRODUCTION;
+    }
+
+    int lhs(uint32_t production) const { return lhsOf[production]; }
+    const int32_t* rhsBegin(uint32_t production) const { return rhsSymbols + rhsStart[production]; }
+    const int32_t* rhsEnd(uint32_t production) const { return rhsSymbols + rhsStart[production + 1]; }
+
+    std::string_view nonTerminalName(int i) const { return name(i); }
+    std::string_view terminalName(int i) const { return name(rows + i); }
+
+private:
+    char* mapped = nullptr;
+    size_t mappedSize = 0;
+    uint32_t rows = 0, columns = 0, productions = 0;
+    const int32_t* base = nullptr;
+    const int32_t* check = nullptr;
+    const int32_t* next = nullptr;
+    const int32_t* lhsOf = nullptr;
+    const uint32_t* rhsStart = nullptr;
+    const int32_t* rhsSymbols = nullptr;
+    const uint32_t* nameStart = nullptr;
+    const char* namePool = nullptr;
+
+    // Function to check that starts[0..count] runs from 0 up to total without going down
+    static bool ascending(const uint32_t* starts, size_t count, uint32_t total) {
+        if (starts[0] != 0 || starts[count] != total) return false;
+        for (size_t i = 0; i < count; ++i) {
+            if (starts[i + 1] < starts[i]) return false;
+        }
+        return true;
+    }
+
+        std::string_view name(size_t i) const {
+        return std::string_view(namePool + nameStart[i], nameStart[i + 1] - nameStart[i]);
+    }
+};
+
+#endif
@@ -0,0 +1,139 @@
+#include <iostream>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "ll1_table.h"
+
+using namespace std;
+
+// Check of LL1TableFile::attach against damaged table images. A good image
+// must attach and answer every lookup like the dense table. Every truncation,
+// and each field set out of range, must be refused. Images with random bytes
+// flipped must either be refused or be safe to read in full, which a build
+// with -fsanitize=address verifies.
+// Build: g++ -O2 -std=c++17 ll1_table_check.cpp -o ll1_table_check
+// Usage: ./ll1_table_check [flipped images] [seed]
+
+static const char* grammarText =
+    "E -> T E'\n"
+    "E' -> + T E' | ε\n"
+    "T -> F T'\n"
+    "T' -> * F T' | ε\n"
+    "F -> ( E ) | id\n";
+
+// A table image copied into 4-byte words, so it is aligned as attach requires
+struct Image {
+    vector<uint32_t> words;
+    size_t size;
+
+    explicit Image(const string& bytes) : words((bytes.size() + 3) / 4), size(bytes.size()) {
+        memcpy(words.data(), bytes.data(), size);
+    }
+    const char* data() const { return (const char*)words.data(); }
+};
+
+// Function to read every lookup, production and name the table offers; returns a checksum
+size_t readAll(const LL1TableFile& table) {
+    size_t sum = 0;
+    for (size_t nt = 0; nt < table.nonTerminalCount(); ++nt) {
+        for (size_t t = 0; t < table.terminalCount(); ++t) sum += table.at((int)nt, (int)t) + 1;
+        sum += table.nonTerminalName((int)nt).size();
+    }
+    for (size_t t = 0; t < table.terminalCount(); ++t) sum += table.terminalName((int)t).size();
+    for (uint32_t p = 0; p < table.productionCount(); ++p) {
+        sum += table.nonTerminalName(table.lhs(p)).size();
+        for (const int32_t* sym = table.rhsBegin(p); sym != table.rhsEnd(p); ++sym) {
+            sum += *sym >= 0 ? table.terminalName(*sym).size() : table.nonTerminalName(-*sym - 1).size();
+        }
+    }
+    return sum;
+}
+
+int main(int argc, char* argv[]) {
+    size_t flips = argc > 1 ? stoul(argv[1]) : 20000;
+    mt19937 rng(argc > 2 ? stoul(argv[2]) : 12345);
+
+    Grammar grammar;
+    grammar.intern("$");
+    grammar.parse(grammarText);
+    FirstSets firstSets = computeAllFirst(grammar);
+    LL1Table dense(grammar, firstSets, computeFollow(grammar, firstSets, grammar.find("$")));
+    const Image good(serializeLL1Table(grammar, compressTable(dense)));
+    int failures = 0;
+
+    // The undamaged image answers like the dense table
+    LL1TableFile table;
+    if (!table.attach(good.data(), good.size)) {
+        cout << "The undamaged image was refused" << endl;
+        return 1;
+    }
+    for (size_t nt = 0; nt < dense.nonTerminalCount(); ++nt) {
+        for (size_t t = 0; t < dense.terminalCount(); ++t) {
+            if (table.at((int)nt, (int)t) != dense.at((int)nt, (int)t)) failures++;
+        }
+    }
+    if (failures) cout << failures << " lookups differ from the dense table" << endl;
+
+    // Every truncation is refused
+    for (size_t size = 0; size < good.size; ++size) {
+        if (table.attach(good.data(), size)) {
+            cout << "Image truncated to " << size << " bytes was accepted" << endl;
+            failures++;
+        }
+    }
+
+    // Each field set out of range is refused; offsets are in words after the 8-word header
+    const LL1TableHeader& header = *(const LL1TableHeader*)good.data();
+    size_t baseAt = 8, checkAt = baseAt + header.nonTerminalCount, nextAt = checkAt + header.combSize;
+    size_t lhsAt = nextAt + header.combSize, rhsStartAt = lhsAt + header.productionCount;
+    size_t rhsAt = rhsStartAt + header.productionCount + 1, nameStartAt = rhsAt + header.rhsSize;
+    size_t ownedSlot = 0;
+    while ((int32_t)good.words[checkAt + ownedSlot] < 0) ownedSlot++;
+    struct Damage {
+        const char* what;
+        size_t word;
+        uint32_t value;
+    };
+    const Damage damages[] = {
+        {"no non-terminals", 2, 0},
+        {"base past the comb", baseAt, header.combSize},
+        {"negative base", baseAt, (uint32_t)-5},
+        {"check naming a missing row", checkAt, header.nonTerminalCount},
+        {"check below -1", checkAt, (uint32_t)-2},
+        {"owned slot with a missing production", nextAt + ownedSlot, header.productionCount},
+        {"owned slot with no production", nextAt + ownedSlot, (uint32_t)-1},
+        {"lhs naming a missing row", lhsAt, header.nonTerminalCount},
+        {"rhsStart not starting at 0", rhsStartAt, 1},
+        {"rhsStart out of order", rhsStartAt + 1, header.rhsSize + 1},
+        {"rhs terminal past the columns", rhsAt, header.terminalCount},
+        {"rhs non-terminal past the rows", rhsAt, (uint32_t)-(int32_t)(header.nonTerminalCount + 1)},
+        {"nameStart out of order", nameStartAt + 1, header.namesSize + 1},
+        {"nameStart past the pool", nameStartAt + header.nonTerminalCount + header.terminalCount,
+         header.namesSize + 1},
+    };
+    for (const Damage& damage : damages) {
+        Image bad = good;
+        bad.words[damage.word] = damage.value;
+        if (table.attach(bad.data(), bad.size)) {
+            cout << "Image with " << damage.what << " was accepted" << endl;
+            failures++;
+        }
+    }
+
+    // Randomly damaged images are refused or safe to read in full
+    size_t accepted = 0, checksum = 0;
+    for (size_t i = 0; i < flips; ++i) {
+        Image bad = good;
+        char* bytes = (char*)bad.words.data();
+        for (unsigned f = 1 + rng() % 4; f > 0; --f) bytes[rng() % bad.size] ^= 1 + rng() % 255;
+        if (!table.attach(bad.data(), bad.size)) continue;
+        accepted++;
+        checksum += readAll(table);
+    }
+
+    if (failures) return 1;
+    cout << "Damaged images refused; " << accepted << " of " << flips << " randomly damaged images were valid "
+         << "and read safely (checksum " << checksum << ")" << endl;
+    return 0;
+}
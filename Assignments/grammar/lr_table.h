@@ -0,0 +1,398 @@
+#ifndef LR_TABLE_H
+#define LR_TABLE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "first_follow.h"
+
+// LR(0) automaton, LALR(1) and SLR(1) lookaheads, and the shift-reduce table.
+//
+// The grammar is augmented with a virtual production S' -> S (production ID
+// productionCount(), S the first non-terminal); reducing by it is accepting.
+// An item is one integer: the first item of a production plus the dot
+// position. A state is identified by its kernel, the sorted items that were
+// moved over a symbol to reach it. Kernels are hash-consed (one flat pool, an
+// open-addressing table keyed by their contents), so each distinct item set
+// is built and closed exactly once and finding a goto target is one hash.
+//
+// LALR(1) lookaheads follow DeRemer and Pennello. Every non-terminal
+// transition (p, A) gets the set of terminals read right after it; "reads"
+// and "includes" relations link those sets, and each is closed with
+// propagateOverComponents(), the same SCC sweep FIRST and FOLLOW use. A
+// reduction by A -> ω in state q then looks ahead at the union of the sets of
+// the transitions (p, A) with p --ω--> q. SLR(1) simply uses FOLLOW(A).
+//
+// Symbols in the automaton are codes: terminal t as t, non-terminal n as
+// terminalCount + n.
+
+#define LR_ERROR 0
+#define LR_NO_STATE (-1)
+
+// Table action encodings: shift to state s, or reduce by production p
+inline int32_t lrShift(uint32_t state) { return (int32_t)state + 1; }
+inline int32_t lrReduce(uint32_t production) { return -(int32_t)production - 1; }
+
+struct LR0Automaton {
+    size_t terminals = 0;       // Symbol codes below this are terminals
+    uint32_t augmented = 0;     // Production ID of S' -> S
+
+    // Items, per production in ID order, the augmented production last
+    std::vector<uint32_t> itemStart;       // First item of each production, plus an end
+    std::vector<int32_t> itemSymbol;       // Symbol code after the dot, -1 when complete
+    std::vector<uint32_t> itemProduction;
+
+    // States: kernel items, outgoing transitions by symbol code, complete items
+    std::vector<uint32_t> kernelStart, kernelItems;
+    std::vector<uint32_t> transitionStart;
+    std::vector<int32_t> transitionSymbol, transitionTarget;
+    std::vector<uint32_t> reductionStart, reductionProduction;
+
+    size_t stateCount() const { return kernelStart.size() - 1; }
+    size_t reductionCount() const { return reductionProduction.size(); }
+
+    // Function to find the transition of a state on a symbol code; -1 if there is none
+    int32_t findTransition(uint32_t state, int32_t symbol) const {
+        const int32_t* first = transitionSymbol.data() + transitionStart[state];
+        const int32_t* last = transitionSymbol.data() + transitionStart[state + 1];
+        const int32_t* at = std::lower_bound(first, last, symbol);
+        return at != last && *at == symbol ? (int32_t)(at - transitionSymbol.data()) : -1;
+    }
+};
+
+// Function to build the LR(0) automaton of a grammar
+inline LR0Automaton buildLR0(const Grammar& grammar) {
+    LR0Automaton lr;
+    size_t terminals = grammar.terminalCount(), nonTerminals = grammar.nonTerminalCount();
+    uint32_t productions = grammar.productionCount();
+    lr.terminals = terminals;
+    lr.augmented = productions;
+
+    // Number the items and note which non-terminals can start each non-terminal
+    std::vector<std::vector<int>> leading(nonTerminals);
+    for (uint32_t p = 0; p < productions; ++p) {
+        lr.itemStart.push_back(lr.itemSymbol.size());
+        for (SymbolId sym : grammar.rhs(p)) {
+            int nt = grammar.nonTerminalIndex(sym);
+            lr.itemSymbol.push_back(nt >= 0 ? (int32_t)(terminals + nt) : grammar.terminalIndex(sym));
+            lr.itemProduction.push_back(p);
+        }
+        lr.itemSymbol.push_back(-1);
+        lr.itemProduction.push_back(p);
+        SymbolSpan rhs = grammar.rhs(p);
+        if (!rhs.empty() && grammar.isNonTerminal(rhs[0])) {
+            leading[grammar.nonTerminalIndex(grammar.lhs(p))].push_back(grammar.nonTerminalIndex(rhs[0]));
+        }
+    }
+    lr.itemStart.push_back(lr.itemSymbol.size());
+    if (nonTerminals > 0) {
+        lr.itemSymbol.push_back((int32_t)terminals);
+        lr.itemProduction.push_back(productions);
+    }
+    lr.itemSymbol.push_back(-1);
+    lr.itemProduction.push_back(productions);
+    lr.itemStart.push_back(lr.itemSymbol.size());
+
+    // Kernel hash table; slots hold state IDs
+    std::vector<int32_t> slots(1024, LR_NO_STATE);
+    std::vector<uint32_t> slotHash;
+    auto hashKernel = [](const uint32_t* items, size_t count) {
+        uint32_t h = 2166136261u;
+        for (size_t i = 0; i < count; ++i) h = (h ^ items[i]) * 16777619u;
+        return h ^ (h >> 15);
+    };
+    auto findOrAdd = [&](const uint32_t* items, size_t count) {
+        uint32_t h = hashKernel(items, count);
+        size_t mask = slots.size() - 1;
+        for (size_t i = h & mask;; i = (i + 1) & mask) {
+            int32_t state = slots[i];
+            if (state == LR_NO_STATE) break;
+            uint32_t start = lr.kernelStart[state], end = lr.kernelStart[state + 1];
+            if (slotHash[state] == h && end - start == count &&
+                std::equal(items, items + count, lr.kernelItems.begin() + start)) {
+                return (uint32_t)state;
+            }
+        }
+
+        uint32_t state = lr.kernelStart.size() - 1;
+        lr.kernelItems.insert(lr.kernelItems.end(), items, items + count);
+        lr.kernelStart.push_back(lr.kernelItems.size());
+        slotHash.push_back(h);
+        if (slotHash.size() * 2 > slots.size()) {
+            slots.assign(slots.size() * 2, LR_NO_STATE);
+            mask = slots.size() - 1;
+            for (uint32_t s = 0; s <= state; ++s) {
+                size_t i = slotHash[s] & mask;
+                while (slots[i] != LR_NO_STATE) i = (i + 1) & mask;
+                slots[i] = (int32_t)s;
+            }
+        } else {
+            size_t i = h & mask;
+            while (slots[i] != LR_NO_STATE) i = (i + 1) & mask;
+            slots[i] = (int32_t)state;
+        }
+        return state;
+    };
+
+    lr.kernelStart.push_back(0);
+    uint32_t startItem = lr.itemStart[productions];
+    findOrAdd(&startItem, 1);
+    lr.transitionStart.push_back(0);
+    lr.reductionStart.push_back(0);
+
+    std::vector<std::vector<uint32_t>> moved(terminals + nonTerminals);
+    std::vector<int32_t> touched;
+    std::vector<uint32_t> items;
+    std::vector<int> closedNonTerminals;
+    std::vector<uint32_t> closedIn(nonTerminals, UINT32_MAX); // Last state that added the non-terminal
+    auto addNonTerminal = [&](int nt, uint32_t state) {
+        if (closedIn[nt] == state) return;
+        closedIn[nt] = state;
+        closedNonTerminals.push_back(nt);
+    };
+
+    for (uint32_t state = 0; state < lr.stateCount(); ++state) {
+        // Closure: the kernel plus the first item of every production of every reachable non-terminal
+        items.assign(lr.kernelItems.begin() + lr.kernelStart[state],
+                     lr.kernelItems.begin() + lr.kernelStart[state + 1]);
+        closedNonTerminals.clear();
+        for (uint32_t item : items) {
+            if (lr.itemSymbol[item] >= (int32_t)terminals) addNonTerminal(lr.itemSymbol[item] - terminals, state);
+        }
+        for (size_t i = 0; i < closedNonTerminals.size(); ++i) {
+            for (int next : leading[closedNonTerminals[i]]) addNonTerminal(next, state);
+        }
+        for (int nt : closedNonTerminals) {
+            for (uint32_t p : grammar.productionsOf(nt)) items.push_back(lr.itemStart[p]);
+        }
+
+        // Group the items by the symbol after the dot; complete items are reductions
+        size_t firstReduction = lr.reductionProduction.size();
+        for (uint32_t item : items) {
+            int32_t symbol = lr.itemSymbol[item];
+            if (symbol < 0) {
+                lr.reductionProduction.push_back(lr.itemProduction[item]);
+                continue;
+            }
+            if (moved[symbol].empty()) touched.push_back(symbol);
+            moved[symbol].push_back(item + 1);
+        }
+        std::sort(lr.reductionProduction.begin() + firstReduction, lr.reductionProduction.end());
+        lr.reductionStart.push_back(lr.reductionProduction.size());
+
+        std::sort(touched.begin(), touched.end());
+        for (int32_t symbol : touched) {
+            std::vector<uint32_t>& kernel = moved[symbol];
+            std::sort(kernel.begin(), kernel.end());
+            lr.transitionSymbol.push_back(symbol);
+            lr.transitionTarget.push_back(findOrAdd(kernel.data(), kernel.size()));
+            kernel.clear();
+        }
+        touched.clear();
+        lr.transitionStart.push_back(lr.transitionSymbol.size());
+    }
+    return lr;
+}
+
+// Function to compute LALR(1) lookaheads, one set per reduction of the automaton
+inline std::vector<TerminalSet> computeLALRLookaheads(const Grammar& grammar, const LR0Automaton& lr,
+                                                      const std::vector<bool>& nullable, SymbolId endMarker) {
+    size_t terminals = lr.terminals;
+    int end = grammar.terminalIndex(endMarker);
+
+    // Number the non-terminal transitions
+    std::vector<int32_t> ntTransitionOf(lr.transitionSymbol.size(), -1);
+    std::vector<uint32_t> ntFrom, ntTarget;
+    std::vector<int> ntSymbol;
+    for (uint32_t state = 0; state < lr.stateCount(); ++state) {
+        for (uint32_t k = lr.transitionStart[state]; k < lr.transitionStart[state + 1]; ++k) {
+            if (lr.transitionSymbol[k] < (int32_t)terminals) continue;
+            ntTransitionOf[k] = ntFrom.size();
+            ntFrom.push_back(state);
+            ntSymbol.push_back(lr.transitionSymbol[k] - terminals);
+            ntTarget.push_back(lr.transitionTarget[k]);
+        }
+    }
+    size_t count = ntFrom.size();
+    std::vector<TerminalSet> sets(count, TerminalSet(terminals));
+
+    // Directly read terminals, and reads: (p, A) reads (q, C) when p --A--> q --C--> and C is nullable.
+    // Both depend only on q, so they are worked out once per state.
+    std::vector<TerminalSet> shifted(lr.stateCount(), TerminalSet(terminals));
+    std::vector<std::vector<int>> nullableExits(lr.stateCount());
+    for (uint32_t q = 0; q < lr.stateCount(); ++q) {
+        for (uint32_t k = lr.transitionStart[q]; k < lr.transitionStart[q + 1]; ++k) {
+            int32_t symbol = lr.transitionSymbol[k];
+            if (symbol < (int32_t)terminals) {
+                shifted[q].insert(symbol);
+            } else if (nullable[symbol - terminals]) {
+                nullableExits[q].push_back(ntTransitionOf[k]);
+            }
+        }
+    }
+    std::vector<std::vector<int>> edges(count);
+    for (size_t x = 0; x < count; ++x) {
+        sets[x] = shifted[ntTarget[x]];
+        edges[x] = nullableExits[ntTarget[x]];
+    }
+    int32_t startTransition = lr.stateCount() > 0 ? lr.findTransition(0, (int32_t)terminals) : -1;
+    if (startTransition >= 0 && end >= 0) sets[ntTransitionOf[startTransition]].insert(end);
+    propagateOverComponents(edges, sets);
+
+    // Whether everything from an item's dot onwards can vanish
+    std::vector<bool> restNullable(lr.itemSymbol.size(), true);
+    for (size_t item = lr.itemSymbol.size(); item-- > 0;) {
+        int32_t symbol = lr.itemSymbol[item];
+        if (symbol >= 0) {
+            restNullable[item] = symbol >= (int32_t)terminals && nullable[symbol - terminals] && restNullable[item + 1];
+        }
+    }
+
+    // includes: (p, A) includes (p', B) when B -> β A γ, γ nullable and p' --β--> p.
+    // Walking each B -> ω from p' also finds lookback: the reduction by B -> ω
+    // in the state the walk ends in looks ahead at (p', B).
+    for (auto& e : edges) e.clear();
+    std::vector<std::pair<uint32_t, uint32_t>> lookback; // (reduction, transition)
+    for (size_t x = 0; x < count; ++x) {
+        for (uint32_t p : grammar.productionsOf(ntSymbol[x])) {
+            uint32_t state = ntFrom[x];
+            for (uint32_t item = lr.itemStart[p]; lr.itemSymbol[item] >= 0; ++item) {
+                int32_t k = lr.findTransition(state, lr.itemSymbol[item]);
+                if (lr.itemSymbol[item] >= (int32_t)terminals && restNullable[item + 1]) {
+                    edges[ntTransitionOf[k]].push_back(x);
+                }
+                state = lr.transitionTarget[k];
+            }
+            const uint32_t* first = lr.reductionProduction.data() + lr.reductionStart[state];
+            const uint32_t* last = lr.reductionProduction.data() + lr.reductionStart[state + 1];
+            lookback.push_back({(uint32_t)(std::lower_bound(first, last, p) - lr.reductionProduction.data()), x});
+        }
+    }
+    propagateOverComponents(edges, sets);
+
+    std::vector<TerminalSet> lookaheads(lr.reductionCount(), TerminalSet(terminals));
+    for (const auto& link : lookback) lookaheads[link.first].unite(sets[link.second]);
+    for (size_t r = 0; r < lr.reductionCount(); ++r) {
+        if (lr.reductionProduction[r] == lr.augmented && end >= 0) lookaheads[r].insert(end);
+    }
+    return lookaheads;
+}
+
+// Function to compute SLR(1) lookaheads: FOLLOW of the reduced non-terminal
+inline std::vector<TerminalSet> computeSLRLookaheads(const Grammar& grammar, const LR0Automaton& lr,
+                                                     const std::vector<TerminalSet>& followSets, SymbolId endMarker) {
+    std::vector<TerminalSet> lookaheads(lr.reductionCount(), TerminalSet(lr.terminals));
+    int end = grammar.terminalIndex(endMarker);
+    for (size_t r = 0; r < lr.reductionCount(); ++r) {
+        uint32_t p = lr.reductionProduction[r];
+        if (p == lr.augmented) {
+            if (end >= 0) lookaheads[r].insert(end);
+        } else {
+            lookaheads[r] = followSets[grammar.nonTerminalIndex(grammar.lhs(p))];
+        }
+    }
+    return lookaheads;
+}
+
+struct LRConflict {
+    uint32_t state;
+    int terminal;      // Dense terminal index
+    int32_t chosen;    // Action that keeps the cell (a shift, or the lower production)
+    int32_t rejected;  // Action that also wanted it
+};
+
+// Shift-reduce parse table: ACTION by state and terminal, GOTO by state and non-terminal.
+// Conflicts are resolved as yacc does, shift over reduce and the earlier
+// production between two reductions, and recorded.
+class LRTable {
+public:
+    LRTable(const Grammar& grammar, const LR0Automaton& lr, const std::vector<TerminalSet>& lookaheads)
+        : states(lr.stateCount()), terminals(lr.terminals), nonTerminals(grammar.nonTerminalCount()),
+          acceptProduction(lr.augmented), actions(states * terminals, LR_ERROR),
+          gotos(states * nonTerminals, LR_NO_STATE) {
+        for (uint32_t p = 0; p < grammar.productionCount(); ++p) {
+            lhsOf.push_back(grammar.nonTerminalIndex(grammar.lhs(p)));
+            lengthOf.push_back(grammar.rhs(p).size());
+        }
+        lhsOf.push_back(-1);
+        lengthOf.push_back(1);
+
+        for (uint32_t state = 0; state < states; ++state) {
+            for (uint32_t k = lr.transitionStart[state]; k < lr.transitionStart[state + 1]; ++k) {
+                int32_t symbol = lr.transitionSymbol[k];
+                if (symbol < (int32_t)terminals) {
+                    actions[state * terminals + symbol] = lrShift(lr.transitionTarget[k]);
+                } else {
+                    gotos[state * nonTerminals + (symbol - terminals)] = lr.transitionTarget[k];
+                }
+            }
+            for (uint32_t r = lr.reductionStart[state]; r < lr.reductionStart[state + 1]; ++r) {
+                int32_t reduce = lrReduce(lr.reductionProduction[r]);
+                lookaheads[r].forEach([&](int terminal) { claim(state, terminal, reduce); });
+            }
+        }
+    }
+
+    size_t stateCount() const { return states; }
+    size_t terminalCount() const { return terminals; }
+    size_t nonTerminalCount() const { return nonTerminals; }
+    int32_t action(uint32_t state, int terminal) const { return actions[state * terminals + terminal]; }
+    int32_t gotoState(uint32_t state, int nonTerminal) const { return gotos[state * nonTerminals + nonTerminal]; }
+
+    // Reducing by this production means the input is accepted
+    uint32_t accepting() const { return acceptProduction; }
+    int lhs(uint32_t production) const { return lhsOf[production]; }
+    uint32_t length(uint32_t production) const { return lengthOf[production]; }
+
+    const std::vector<LRConflict>& conflicts() const { return conflictList; }
+
+private:
+    size_t states, terminals, nonTerminals;
+    uint32_t acceptProduction;
+    std::vector<int32_t> actions, gotos;
+    std::vector<int32_t> lhsOf;
+    std::vector<uint32_t> lengthOf;
+    std::vector<LRConflict> conflictList;
+
+    void claim(uint32_t state, int terminal, int32_t reduce) {
+        int32_t& cell = actions[state * terminals + terminal];
+        if (cell == LR_ERROR) {
+            cell = reduce;
+        } else if (cell != reduce) {
+            conflictList.push_back(LRConflict{state, terminal, cell, reduce});
+        }
+    }
+};
+
+// Function to build a table in one go; slr selects SLR(1) lookaheads instead of LALR(1)
+inline LRTable buildLRTable(const Grammar& grammar, SymbolId endMarker, bool slr = false) {
+    LR0Automaton lr = buildLR0(grammar);
+    if (slr) {
+        FirstSets firstSets = computeAllFirst(grammar);
+        return LRTable(grammar, lr, computeSLRLookaheads(grammar, lr, computeFollow(grammar, firstSets, endMarker),
+                                                         endMarker));
+    }
+    return LRTable(grammar, lr, computeLALRLookaheads(grammar, lr, computeNullable(grammar), endMarker));
+}
+
+// Function to describe one table action, e.g. "shift 7" or "reduce E -> E + T"
+inline std::string describeLRAction(const Grammar& grammar, const LRTable& table, int32_t action) {
+    if (action > 0) return "shift " + std::to_string(action - 1);
+    if (action == LR_ERROR) return "error";
+    uint32_t production = -action - 1;
+    if (production == table.accepting()) return "accept";
+    return "reduce " + std::string(grammar.name(grammar.lhs(production))) + " -> " + grammar.formatRhs(production);
+}
+
+// Function to describe a conflict, e.g. "state 9 on +: shift 6 | reduce E -> E + E"
+inline std::string describeConflict(const Grammar& grammar, const LRTable& table, const LRConflict& conflict) {
+    return "state " + std::to_string(conflict.state) + " on " +
+           std::string(grammar.name(grammar.terminal(conflict.terminal))) + ": " +
+           describeLRAction(grammar, table, conflict.chosen) + " | " +
+           describeLRAction(grammar, table, conflict.rejected);
+}
+
+#endif
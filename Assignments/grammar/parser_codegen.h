@@ -0,0 +1,336 @@
+#ifndef PARSER_CODEGEN_H
+#define PARSER_CODEGEN_H
+
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "ll1_table.h"
+#include "lr_table.h"
+
+// Parser code generation: writes a C++ header specialised to one grammar, so
+// a parser starts with nothing to load or build.
+//
+// Both kinds of header hold the symbol names and a terminalOf() that maps a
+// scanner token to a terminal with switches over the token kind and the
+// lexeme, using the same rules as parser/parser_common.h. For an LL(1) table
+// the parser is direct-coded recursive descent: one labelled block per
+// non-terminal, a switch on the lookahead with one case group per
+// production, so the table itself is compiled into the switches. The last
+// non-terminal of a production is a goto rather than a call, so a long right
+// recursive list such as P -> S P does not grow the stack, unoptimised or not.
+// For an LR table it is the shift-reduce loop over constexpr ACTION and GOTO
+// arrays.
+// The headers include the scanner's lexer.h, so the Assignment_2 directory
+// must be on the include path.
+
+#define CODEGEN_LINE_WIDTH 100
+
+// Function to turn a file name into a C++ identifier for the namespace, e.g. "out/expr.h" -> "expr"
+inline std::string codegenNamespace(const std::string& filename) {
+    size_t slash = filename.find_last_of('/');
+    std::string stem = filename.substr(slash == std::string::npos ? 0 : slash + 1);
+    stem = stem.substr(0, stem.find('.'));
+    std::string name;
+    for (char c : stem) name += std::isalnum((unsigned char)c) ? c : '_';
+    if (name.empty() || std::isdigit((unsigned char)name[0])) name = "parser_" + name;
+    return name;
+}
+
+// Function to spell a symbol name as a C++ string literal
+inline std::string codegenLiteral(std::string_view text) {
+    std::string literal = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') literal += '\\';
+        literal += c;
+    }
+    return literal + "\"";
+}
+
+// Function to make text safe inside a generated // comment: control bytes
+// become '.', and a trailing backslash, which would splice the next line into
+// the comment even with spaces after it, is closed off with " //"
+inline std::string codegenComment(std::string_view text) {
+    std::string comment;
+    for (char c : text) comment += (unsigned char)c < 0x20 || c == 0x7f ? '.' : c;
+    if (!comment.empty() && comment.back() == '\\') comment += " //";
+    return comment;
+}
+
+// Function to append "constexpr type name[] = { ... };" wrapped at CODEGEN_LINE_WIDTH
+inline void appendArray(std::string& out, const char* type, const char* name, const std::vector<std::string>& items) {
+    out += "constexpr ";
+    out += type;
+    out += ' ';
+    out += name;
+    out += "[] = {";
+    if (items.empty()) out += " 0"; // Zero-length arrays are not allowed
+    size_t lineStart = out.size();
+    for (size_t i = 0; i < items.size(); ++i) {
+        size_t width = items[i].size() + (i + 1 < items.size() ? 2 : 1);
+        if (out.size() - lineStart + width > CODEGEN_LINE_WIDTH) {
+            out += "\n   ";
+            lineStart = out.size();
+        }
+        out += ' ';
+        out += items[i];
+        if (i + 1 < items.size()) out += ',';
+    }
+    out += " };\n";
+}
+
+template <typename Value>
+void appendArray(std::string& out, const char* type, const char* name, const std::vector<Value>& values) {
+    std::vector<std::string> items;
+    for (Value value : values) items.push_back(std::to_string(value));
+    appendArray(out, type, name, items);
+}
+
+// Function to append the names of the terminals and non-terminals
+inline void appendNames(std::string& out, const Grammar& grammar) {
+    std::vector<std::string> terminalNames, nonTerminalNames;
+    for (size_t t = 0; t < grammar.terminalCount(); ++t) {
+        terminalNames.push_back(codegenLiteral(grammar.name(grammar.terminal(t))));
+    }
+    for (size_t n = 0; n < grammar.nonTerminalCount(); ++n) {
+        nonTerminalNames.push_back(codegenLiteral(grammar.name(grammar.nonTerminal(n))));
+    }
+    out += "constexpr int terminalCount = " + std::to_string(grammar.terminalCount()) + ";\n";
+    out += "constexpr int nonTerminalCount = " + std::to_string(grammar.nonTerminalCount()) + ";\n";
+    appendArray(out, "const char*", "terminalNames", terminalNames);
+    appendArray(out, "const char*", "nonTerminalNames", nonTerminalNames);
+    out += "\n";
+}
+
+// Function to append terminalOf(), the token to terminal mapping as switches
+inline void appendTerminalOf(std::string& out, const Grammar& grammar) {
+    auto indexOf = [&](const char* name) {
+        SymbolId id = grammar.find(name);
+        int t = id == NO_SYMBOL ? -1 : grammar.terminalIndex(id);
+        return std::to_string(t);
+    };
+    out += "// Function to find the terminal a token stands for; -1 if the grammar has none\n"
+           "inline int32_t terminalOf(const Token& token, std::string_view lexeme) {\n"
+           "    switch (token.kind) {\n"
+           "    case TokenKind::End: return " + indexOf("$") + ";\n"
+           "    case TokenKind::Identifier: return " + indexOf("id") + ";\n"
+           "    case TokenKind::Integer:\n"
+           "    case TokenKind::Float: return " + indexOf("num") + ";\n"
+           "    case TokenKind::Error: return -1;\n"
+           "    default: break;\n"
+           "    }\n";
+
+    // Group the other terminals by length; single characters get a switch of their own
+    std::vector<std::vector<int>> byLength;
+    for (size_t t = 0; t < grammar.terminalCount(); ++t) {
+        std::string_view name = grammar.name(grammar.terminal(t));
+        if (name.empty() || name == "$" || name == "id" || name == "num") continue;
+        if (byLength.size() <= name.size()) byLength.resize(name.size() + 1);
+        byLength[name.size()].push_back(t);
+    }
+    out += "    switch (lexeme.size()) {\n";
+    for (size_t length = 1; length < byLength.size(); ++length) {
+        if (byLength[length].empty()) continue;
+        out += "    case " + std::to_string(length) + ":\n";
+        if (length == 1) {
+            out += "        switch (lexeme[0]) {\n";
+            for (int t : byLength[length]) {
+                char c = grammar.name(grammar.terminal(t))[0];
+                std::string quoted = c == '\'' || c == '\\' ? std::string("\\") + c : std::string(1, c);
+                out += "        case '" + quoted + "': return " + std::to_string(t) + ";\n";
+            }
+            out += "        }\n";
+        } else {
+            for (int t : byLength[length]) {
+                out += "        if (lexeme == " + codegenLiteral(grammar.name(grammar.terminal(t))) + ") return " +
+                       std::to_string(t) + ";\n";
+            }
+        }
+        out += "        break;\n";
+    }
+    out += "    }\n    return -1;\n}\n\n";
+}
+
+// Function to start a generated header: guard, includes and namespace
+inline std::string codegenPrologue(const std::string& filename, const char* what) {
+    std::string guard;
+    for (char c : codegenNamespace(filename)) guard += (char)std::toupper((unsigned char)c);
+    guard += "_H";
+    return std::string("// ") + what + " generated by grammar_pipeline; do not edit.\n"
+           "// Needs the scanner's lexer.h on the include path.\n"
+           "#ifndef " + guard + "\n#define " + guard + "\n\n"
+           "#include <cstdint>\n#include <string_view>\n#include <vector>\n#include \"lexer.h\"\n\n"
+           "namespace " + codegenNamespace(filename) + " {\n\n";
+}
+
+// Function to write a recursive-descent parser for an LL(1) table
+inline bool emitLL1Parser(const std::string& filename, const Grammar& grammar, const LL1Table& table) {
+    std::string out = codegenPrologue(filename, "LL(1) parser");
+    appendNames(out, grammar);
+    appendTerminalOf(out, grammar);
+
+    SymbolId endMarker = grammar.find("$");
+    int end = endMarker == NO_SYMBOL ? -1 : grammar.terminalIndex(endMarker);
+    out += "// Recursive-descent parser, one labelled block per non-terminal. A non-terminal\n"
+           "// inside a production is a recursive call and the last one is a jump, so right\n"
+           "// recursion runs as a loop and the C++ stack grows only with nesting.\n"
+           "template <typename TokenSource>\n"
+           "class Parser {\n"
+           "public:\n"
+           "    explicit Parser(TokenSource& source) : source(source) {}\n\n"
+           "    // Function to parse one sentence of the start symbol; false at the first syntax error\n"
+           "    bool parse() {\n"
+           "        tokens = productions = 0;\n"
+           "        advance();\n"
+           "        return parseFrom(0) && match(" + std::to_string(end) + ");\n"
+           "    }\n\n"
+           "    const Token& errorToken() const { return token; }  // Where a failed parse stopped\n"
+           "    uint64_t tokenCount() const { return tokens; }\n"
+           "    uint64_t productionCount() const { return productions; }\n\n"
+           "private:\n"
+           "    TokenSource& source;\n"
+           "    Token token{};\n"
+           "    int32_t lookahead = -1;\n"
+           "    uint64_t tokens = 0, productions = 0;\n\n"
+           "    void advance() {\n"
+           "        token = source.next();\n"
+           "        lookahead = terminalOf(token, source.text(token));\n"
+           "    }\n\n"
+           "    bool match(int32_t terminal) {\n"
+           "        if (lookahead != terminal) return false;\n"
+           "        tokens++;\n"
+           "        if (terminal != " + std::to_string(end) + ") advance();\n"
+           "        return true;\n"
+           "    }\n\n"
+           "    // Function to parse one phrase of the given non-terminal\n"
+           "    bool parseFrom(int32_t nonTerminal) {\n"
+           "        switch (nonTerminal) {\n";
+    for (size_t n = 0; n < grammar.nonTerminalCount(); ++n) {
+        out += "        case " + std::to_string(n) + ": goto parse" + std::to_string(n) + ";\n";
+    }
+    out += "        default: return false;\n        }\n";
+
+    auto call = [&](SymbolId symbol) {
+        int nt = grammar.nonTerminalIndex(symbol);
+        return nt >= 0 ? "parseFrom(" + std::to_string(nt) + ")"
+                       : "match(" + std::to_string(grammar.terminalIndex(symbol)) + ")";
+    };
+    for (size_t n = 0; n < grammar.nonTerminalCount(); ++n) {
+        std::string name = codegenComment(grammar.name(grammar.nonTerminal(n)));
+        out += "\n    parse" + std::to_string(n) + ": // " + name + "\n        switch (lookahead) {\n";
+        for (uint32_t p : grammar.productionsOf(n)) {
+            bool used = false;
+            for (size_t t = 0; t < grammar.terminalCount(); ++t) {
+                if (table.at(n, t) != (int32_t)p) continue;
+                std::string terminal = codegenComment(grammar.name(grammar.terminal(t)));
+                out += "        case " + std::to_string(t) + ": // " + terminal + "\n";
+                used = true;
+            }
+            if (!used) continue; // Lost every cell to an earlier production
+
+            std::string production = std::string(grammar.name(grammar.lhs(p))) + " -> " + grammar.formatRhs(p);
+            out += "            // " + codegenComment(production) + "\n            productions++;\n";
+            SymbolSpan rhs = grammar.rhs(p);
+            int tail = rhs.empty() ? -1 : grammar.nonTerminalIndex(rhs[rhs.size() - 1]);
+            size_t calls = tail >= 0 ? rhs.size() - 1 : rhs.size();
+            std::string sequence;
+            for (size_t i = 0; i < calls; ++i) sequence += (i ? " && " : "") + call(rhs[i]);
+            if (tail < 0) {
+                out += "            return " + (sequence.empty() ? std::string("true") : sequence) + ";\n";
+                continue;
+            }
+            // The last non-terminal is jumped to rather than called
+            if (calls == 1) out += "            if (!" + sequence + ") return false;\n";
+            if (calls > 1) out += "            if (!(" + sequence + ")) return false;\n";
+            out += "            goto parse" + std::to_string(tail) + ";\n";
+        }
+        out += "        default:\n            return false;\n        }\n";
+    }
+    out += "    }\n";
+    out += "};\n\n}\n\n#endif\n";
+
+    std::ofstream file(filename);
+    if (!file.is_open()) return false;
+    file << out;
+    return (bool)file;
+}
+
+// Function to write a shift-reduce parser for an LR table
+inline bool emitLRParser(const std::string& filename, const Grammar& grammar, const LRTable& table) {
+    std::string out = codegenPrologue(filename, "LR parser");
+    appendNames(out, grammar);
+
+    std::vector<int32_t> actions, gotos, lhs, length;
+    for (uint32_t s = 0; s < table.stateCount(); ++s) {
+        for (size_t t = 0; t < table.terminalCount(); ++t) actions.push_back(table.action(s, t));
+        for (size_t n = 0; n < table.nonTerminalCount(); ++n) gotos.push_back(table.gotoState(s, n));
+    }
+    for (uint32_t p = 0; p < grammar.productionCount(); ++p) {
+        lhs.push_back(table.lhs(p));
+        length.push_back(table.length(p));
+    }
+    out += "constexpr int stateCount = " + std::to_string(table.stateCount()) + ";\n"
+           "constexpr uint32_t acceptProduction = " + std::to_string(table.accepting()) + ";\n\n"
+           "// ACTION by state and terminal: shift to s as s + 1, reduce by p as -(p + 1), 0 for an error\n";
+    appendArray(out, "int32_t", "actionTable", actions);
+    out += "// GOTO by state and non-terminal, -1 where there is none\n";
+    appendArray(out, "int32_t", "gotoTable", gotos);
+    appendArray(out, "int32_t", "productionLhs", lhs);
+    appendArray(out, "uint32_t", "productionLength", length);
+    out += "\n";
+    appendTerminalOf(out, grammar);
+
+    out += "// Shift-reduce parser; the state stack is reserved once and reused\n"
+           "template <typename TokenSource>\n"
+           "class Parser {\n"
+           "public:\n"
+           "    explicit Parser(TokenSource& source) : source(source) { stack.reserve(4096); }\n\n"
+           "    // Function to parse one sentence of the start symbol; false at the first syntax error\n"
+           "    bool parse() {\n"
+           "        tokens = productions = 0;\n"
+           "        stack.assign(1, 0);\n"
+           "        advance();\n"
+           "        while (lookahead >= 0) {\n"
+           "            int32_t action = actionTable[stack.back() * terminalCount + lookahead];\n"
+           "            if (action > 0) {\n"
+           "                stack.push_back(action - 1);\n"
+           "                tokens++;\n"
+           "                advance();\n"
+           "                continue;\n"
+           "            }\n"
+           "            if (action == 0) return false;\n"
+           "            uint32_t production = -action - 1;\n"
+           "            if (production == acceptProduction) {\n"
+           "                tokens++;\n"
+           "                return true;\n"
+           "            }\n"
+           "            stack.resize(stack.size() - productionLength[production]);\n"
+           "            stack.push_back(gotoTable[stack.back() * nonTerminalCount + productionLhs[production]]);\n"
+           "            productions++;\n"
+           "        }\n"
+           "        return false;\n"
+           "    }\n\n"
+           "    const Token& errorToken() const { return token; }  // Where a failed parse stopped\n"
+           "    uint64_t tokenCount() const { return tokens; }\n"
+           "    uint64_t productionCount() const { return productions; }\n\n"
+           "private:\n"
+           "    TokenSource& source;\n"
+           "    std::vector<int32_t> stack;\n"
+           "    Token token{};\n"
+           "    int32_t lookahead = -1;\n"
+           "    uint64_t tokens = 0, productions = 0;\n\n"
+           "    void advance() {\n"
+           "        token = source.next();\n"
+           "        lookahead = terminalOf(token, source.text(token));\n"
+           "    }\n"
+           "};\n\n}\n\n#endif\n";
+
+    std::ofstream file(filename);
+    if (!file.is_open()) return false;
+    file << out;
+    return (bool)file;
+}
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef WORK_STEALING_H
+#define WORK_STEALING_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing thread pool for the grammar transformations.
+//
+// Every worker owns a deque of tasks. Tasks a worker spawns go on the back
+// of its own deque and it pops from the back, so it keeps working on what it
+// just produced; an idle worker steals from the front of another worker's
+// deque, taking the oldest piece of work. A count of unfinished tasks tells
+// the workers when everything, including tasks spawned along the way, is
+// done. A worker that finds every deque empty sleeps on a condition variable
+// until a task is queued or the last one finishes, so waiting for a long task
+// costs no CPU. The calling thread is worker 0, so one thread means no threads
+// are started at all.
+
+template <typename Task>
+class WorkStealingPool {
+public:
+    // threads == 0 means one worker per hardware thread
+    explicit WorkStealingPool(unsigned threads)
+        : queues(threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads) {}
+
+    unsigned threadCount() const { return (unsigned)queues.size(); }
+
+    // Function to queue a task before run(), spread round-robin over the workers
+    void add(Task task) {
+        push(nextQueue, task);
+        nextQueue = (nextQueue + 1) % threadCount();
+    }
+
+    // Function to queue a task from inside work(), on the spawning worker's deque
+    void spawn(unsigned worker, Task task) { push(worker, task); }
+
+    // Function to call work(task, worker) for every queued and spawned task
+    template <typename Work>
+    void run(Work work) {
+        auto worker = [&](unsigned self) {
+            Task task;
+            while (unfinished.load() > 0) {
+                if (!pop(self, task) && !steal(self, task)) {
+                    sleep();
+                    continue;
+                }
+                work(task, self);
+                if (--unfinished == 0) wake(true);
+            }
+        };
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < threadCount(); t++) pool.emplace_back(worker, t);
+        worker(0);
+        for (auto& thread : pool) thread.join();
+    }
+
+private:
+    struct Queue {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<Queue> queues;
+    std::atomic<size_t> unfinished{0}; // Queued or running; a spawn counts before its parent finishes
+    std::atomic<size_t> queued{0};     // Waiting in a deque
+    std::atomic<unsigned> sleepers{0}; // Workers inside sleep()
+    std::mutex idleLock;
+    std::condition_variable idle;
+    unsigned nextQueue = 0;
+
+    void push(unsigned worker, Task task) {
+        unfinished++;
+        {
+            std::lock_guard<std::mutex> guard(queues[worker].lock);
+            queues[worker].tasks.push_back(task);
+            queued++;
+        }
+        wake(false);
+    }
+
+    // Function to wait until a task is queued or every task has finished. A
+    // sleeper is counted before it checks, and a waker checks the count after
+    // queueing, so one of the two always sees the other.
+    void sleep() {
+        std::unique_lock<std::mutex> guard(idleLock);
+        sleepers++;
+        idle.wait(guard, [&] { return queued.load() > 0 || unfinished.load() == 0; });
+        sleepers--;
+    }
+
+    // Function to wake one sleeper for a new task, or all of them when the work is done
+    void wake(bool all) {
+        if (sleepers.load() == 0) return;
+        std::lock_guard<std::mutex> guard(idleLock);
+        if (all) idle.notify_all();
+        else idle.notify_one();
+    }
+
+    bool pop(unsigned worker, Task& task) {
+        std::lock_guard<std::mutex> guard(queues[worker].lock);
+        if (queues[worker].tasks.empty()) return false;
+        task = queues[worker].tasks.back();
+        queues[worker].tasks.pop_back();
+        queued--;
+        return true;
+    }
+
+    bool steal(unsigned thief, Task& task) {
+        for (unsigned i = 1; i < threadCount(); i++) {
+            Queue& victim = queues[(thief + i) % threadCount()];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (victim.tasks.empty()) continue;
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            queued--;
+            return true;
+        }
+        return false;
+    }
+};
+
+#endif
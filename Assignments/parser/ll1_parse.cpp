@@ -0,0 +1,58 @@
+#include <iostream>
+#include <cstring>
+#include "ll1_parser.h"
+
+using namespace std;
+
+// Parse a source file with an LL(1) table written by grammar_pipeline --ll1.
+// Build: g++ -O2 -std=c++17 ll1_parse.cpp -o ll1_parse
+// Usage: ./ll1_parse table.bin [input.txt | -] [-d]
+//   -d  print the leftmost derivation, one production per line
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cout << "Usage: " << argv[0] << " table.bin [input.txt | -] [-d]" << endl;
+        return 1;
+    }
+    const char* inputName = "input.txt";
+    bool printDerivation = false;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "-d") == 0) {
+            printDerivation = true;
+        } else {
+            inputName = argv[i];
+        }
+    }
+
+    LL1TableFile table;
+    if (!table.open(argv[1])) {
+        cout << "Error loading table: " << argv[1] << endl;
+        return 1;
+    }
+    InputBuffer input;
+    if (!input.open(inputName)) {
+        cout << "Error opening file: " << inputName << endl;
+        return 1;
+    }
+
+    // Function to print one production as "A -> x B"
+    auto printProduction = [&](int32_t production) {
+        string text(table.nonTerminalName(table.lhs(production)));
+        text += " ->";
+        for (const int32_t* sym = table.rhsBegin(production); sym != table.rhsEnd(production); ++sym) {
+            text += ' ';
+            text += *sym >= 0 ? table.terminalName(*sym) : table.nonTerminalName(-*sym - 1);
+        }
+        cout << text << '\n';
+    };
+
+    Lexer lexer(input);
+    LL1Parser parser(table);
+    ParseResult result = printDerivation ? parser.parse(lexer, printProduction) : parser.parse(lexer);
+    if (!result.accepted) {
+        cout << "Syntax error at " << parser.describeError(result, lexer.text(result.errorToken)) << endl;
+        return 1;
+    }
+    cout << "Accepted: " << result.tokens << " tokens, " << result.productions << " expansions" << endl;
+    return 0;
+}
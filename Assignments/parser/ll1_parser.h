@@ -0,0 +1,97 @@
+#ifndef LL1_PARSER_H
+#define LL1_PARSER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../grammar/ll1_table.h"
+#include "parser_common.h"
+
+// Table-driven predictive parser over the scanner's tokens.
+//
+// The parse stack holds table symbols (terminal t as t, non-terminal n as
+// -(n + 1)) in a vector reserved up front and reused across parses, so once
+// it has reached the depth of the input a parse makes no heap allocation.
+// Tokens come from any source with the Lexer's next()/text() pair, straight
+// from the scanner in memory.
+
+class LL1Parser {
+public:
+    // The table must outlive the parser
+    explicit LL1Parser(const LL1TableFile& table)
+        : table(&table), terminals(table.terminalCount(), [&](size_t t) { return table.terminalName(t); }) {
+        stack.reserve(PARSER_STACK_RESERVE);
+    }
+
+    // Function to parse one sentence of the table's start symbol;
+    // onExpand(production) is called for each step of the leftmost derivation
+    template <typename TokenSource, typename OnExpand>
+    ParseResult parse(TokenSource& source, OnExpand onExpand) {
+        ParseResult result{false, 0, 0, Token{}, 0};
+        int32_t endTerminal = terminals.end();
+        if (endTerminal == PARSER_NO_TERMINAL) return result; // The table has no "$"
+        stack.clear();
+        stack.push_back(endTerminal);
+        stack.push_back(-1); // Start symbol, non-terminal 0
+
+        Token token = source.next();
+        int32_t terminal = terminals.terminalOf(token, source.text(token));
+        while (true) {
+            int32_t top = stack.back();
+            if (top >= 0) {
+                // Terminal on top: it must be the lookahead
+                if (top != terminal) break;
+                result.tokens++;
+                if (terminal == endTerminal) {
+                    result.accepted = true;
+                    return result;
+                }
+                stack.pop_back();
+                token = source.next();
+                terminal = terminals.terminalOf(token, source.text(token));
+                continue;
+            }
+
+            // Non-terminal on top: the table picks the production to expand
+            if (terminal < 0) break;
+            int32_t production = table->at(-top - 1, terminal);
+            if (production == LL1_NO_PRODUCTION) break;
+            stack.pop_back();
+            for (const int32_t* sym = table->rhsEnd(production); sym != table->rhsBegin(production);) {
+                stack.push_back(*--sym);
+            }
+            result.productions++;
+            onExpand(production);
+        }
+
+        result.errorToken = token;
+        result.stackTop = stack.back();
+        return result;
+    }
+
+    template <typename TokenSource>
+    ParseResult parse(TokenSource& source) {
+        return parse(source, [](int32_t) {});
+    }
+
+    // Function to describe a failed parse, e.g. "line 3, col 7: unexpected ')', expected id"
+    std::string describeError(const ParseResult& result, std::string_view lexeme) const {
+        std::string text = describeUnexpected(result, lexeme) + ", expected ";
+        if (result.stackTop >= 0) {
+            text += table->terminalName(result.stackTop);
+        } else {
+            text += "start of ";
+            text += table->nonTerminalName(-result.stackTop - 1);
+        }
+        return text;
+    }
+
+private:
+    const LL1TableFile* table;
+    TerminalMap terminals;
+    std::vector<int32_t> stack;
+};
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef LR_PARSER_H
+#define LR_PARSER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../grammar/lr_table.h"
+#include "parser_common.h"
+
+// Table-driven shift-reduce parser over the scanner's tokens.
+//
+// The stack holds only states; a reduction pops the length of the production
+// and pushes GOTO of the uncovered state. Like LL1Parser the stack is reserved
+// up front and reused across parses, and tokens come from any source with the
+// Lexer's next()/text() pair.
+
+#define LR_EXPECTED_LISTED 6  // Terminals named in an error message
+
+class LRParser {
+public:
+    // The table and the grammar it was built from must outlive the parser
+    LRParser(const LRTable& table, const Grammar& grammar)
+        : table(&table), grammar(&grammar),
+          terminals(table.terminalCount(), [&](size_t t) { return grammar.name(grammar.terminal(t)); }) {
+        stack.reserve(PARSER_STACK_RESERVE);
+    }
+
+    // Function to parse one sentence of the start symbol; onReduce(production)
+    // is called for each reduction, which together spell the rightmost
+    // derivation in reverse
+    template <typename TokenSource, typename OnReduce>
+    ParseResult parse(TokenSource& source, OnReduce onReduce) {
+        ParseResult result{false, 0, 0, Token{}, 0};
+        stack.clear();
+        stack.push_back(0);
+
+        Token token = source.next();
+        int32_t terminal = terminals.terminalOf(token, source.text(token));
+        while (terminal >= 0) {
+            int32_t action = table->action(stack.back(), terminal);
+            if (action > 0) {
+                stack.push_back(action - 1);
+                result.tokens++;
+                token = source.next();
+                terminal = terminals.terminalOf(token, source.text(token));
+                continue;
+            }
+            if (action == LR_ERROR) break;
+
+            uint32_t production = -action - 1;
+            if (production == table->accepting()) {
+                result.tokens++;
+                result.accepted = true;
+                return result;
+            }
+            stack.resize(stack.size() - table->length(production));
+            stack.push_back(table->gotoState(stack.back(), table->lhs(production)));
+            result.productions++;
+            onReduce(production);
+        }
+
+        result.errorToken = token;
+        result.stackTop = stack.back();
+        return result;
+    }
+
+    template <typename TokenSource>
+    ParseResult parse(TokenSource& source) {
+        return parse(source, [](uint32_t) {});
+    }
+
+    // Function to describe a failed parse, e.g. "line 3, col 7: unexpected ')', expected one of id, ("
+    std::string describeError(const ParseResult& result, std::string_view lexeme) const {
+        std::string text = describeUnexpected(result, lexeme) + ", expected one of ";
+        size_t listed = 0;
+        for (size_t t = 0; t < table->terminalCount(); ++t) {
+            if (table->action(result.stackTop, t) == LR_ERROR) continue;
+            if (listed == LR_EXPECTED_LISTED) {
+                text += ", ...";
+                break;
+            }
+            if (listed++ > 0) text += ", ";
+            text += grammar->name(grammar->terminal(t));
+        }
+        return text;
+    }
+
+private:
+    const LRTable* table;
+    const Grammar* grammar;
+    TerminalMap terminals;
+    std::vector<uint32_t> stack;
+};
+
+#endif
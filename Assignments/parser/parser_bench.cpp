@@ -0,0 +1,223 @@
+#include <iostream>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include "../Assignment_2/bench_support.h"
+#include "ll1_parser.h"
+#include "lr_parser.h"
+#ifdef PARSER_BENCH_GENERATED
+#include "bench_ll1_parser.h"
+#include "bench_lr_parser.h"
+#endif
+
+using namespace std;
+
+// Predictive parser benchmark. Generates a large program in a small statement
+// language, builds its LL(1) and LALR(1) tables in process and parses the
+// program with tokens taken straight from the Lexer and from a pre-lexed token
+// array, reporting tokens/s and heap allocations per token.
+//
+// The grammars are bench_ll1.txt and, for the LR parser, the left-recursive
+// bench_lr.txt of the same language. Built with PARSER_BENCH_GENERATED it
+// also runs the parsers grammar_pipeline --emit-ll1 / --emit-lr writes for
+// them, which must accept the program with the same number of productions
+// as the table-driven ones. The CMake build generates both headers.
+// Build: g++ -O2 -std=c++17 parser_bench.cpp -o parser_bench
+//   or, with the generated parsers, from this directory:
+//   ../grammar/grammar_pipeline bench_ll1.txt --emit-ll1 bench_ll1_parser.h
+//   ../grammar/grammar_pipeline bench_lr.txt --emit-lr bench_lr_parser.h
+//   g++ -O2 -std=c++17 -DPARSER_BENCH_GENERATED -I../Assignment_2 parser_bench.cpp -o parser_bench
+// Usage: ./parser_bench [megabytes] [directory of bench_ll1.txt and bench_lr.txt]
+
+static const char* names[] = {"x", "count", "total_sum", "_tmp1", "value2", "averageTemperatureReading"};
+static const char* numbers[] = {"0", "42", "1000", "3.14", "0.5", "65536"};
+static const char* operators[] = {" + ", " - ", " * ", " / ", "+", "*"};
+
+// Function to append a random expression, nesting parentheses at most `depth` deep
+void generateExpression(string& text, mt19937& rng, int depth) {
+    unsigned factors = 1 + rng() % 4;
+    for (unsigned i = 0; i < factors; i++) {
+        if (i > 0) text += operators[rng() % 6];
+        unsigned pick = rng() % 10;
+        if (pick < 2 && depth > 0) {
+            text += '(';
+            generateExpression(text, rng, depth - 1);
+            text += ')';
+        } else if (pick < 6) {
+            text += names[rng() % 6];
+        } else {
+            text += numbers[rng() % 6];
+        }
+    }
+}
+
+// Function to append a random statement, nesting blocks at most `depth` deep
+void generateStatement(string& text, mt19937& rng, int depth, int indent) {
+    text.append(indent * 4, ' ');
+    unsigned pick = rng() % 10;
+    if (pick < 2 && depth > 0) {
+        text += pick == 0 ? "while (" : "if (";
+        generateExpression(text, rng, 2);
+        text += ") {\n";
+        unsigned statements = 1 + rng() % 4;
+        for (unsigned i = 0; i < statements; i++) generateStatement(text, rng, depth - 1, indent + 1);
+        text.append(indent * 4, ' ');
+        text += "}\n";
+    } else {
+        text += names[rng() % 6];
+        text += " = ";
+        generateExpression(text, rng, 3);
+        text += "#\n";
+    }
+}
+
+// Function to generate a program of roughly `size` bytes
+string generateProgram(size_t size) {
+    mt19937 rng(12345);
+    string text;
+    text.reserve(size + 4096);
+    while (text.size() < size) generateStatement(text, rng, 4, 0);
+    return text;
+}
+
+// Token source over tokens lexed beforehand, with the Lexer's next()/text() pair
+struct TokenArraySource {
+    const Token* at;
+    const char* input;
+
+    Token next() { return *at++; }
+    string_view text(const Token& token) const { return string_view(input + token.offset, token.length); }
+};
+
+template <typename Run>
+ParseResult measure(const char* name, Run run) {
+    RunCost cost;
+    ParseResult result = measureRun(run, cost);
+
+    char line[160];
+    snprintf(line, sizeof(line), "  %-28s %12llu tokens %9.2f Mtokens/s %9.4f allocs/token\n", name,
+             (unsigned long long)result.tokens, result.tokens / cost.seconds / 1e6,
+             result.tokens ? (double)cost.allocations / result.tokens : 0.0);
+    cout << line;
+    return result;
+}
+
+#ifdef PARSER_BENCH_GENERATED
+// Function to run a generated parser and report it like the table-driven ones
+template <typename GeneratedParser>
+ParseResult runGenerated(GeneratedParser& parser) {
+    bool accepted = parser.parse();
+    return ParseResult{accepted, parser.tokenCount(), parser.productionCount(), parser.errorToken(), -1};
+}
+#endif
+
+// Function to load a bench grammar with "$" as terminal 0, as grammar_pipeline does
+bool loadGrammar(Grammar& grammar, SymbolId& endMarker, const string& path) {
+    endMarker = grammar.intern("$");
+    if (grammar.load(path)) return true;
+    cout << "Error opening file: " << path << endl;
+    return false;
+}
+
+int main(int argc, char* argv[]) {
+    size_t megabytes = argc > 1 ? stoul(argv[1]) : 64;
+    string directory = argc > 2 ? string(argv[2]) + "/" : "";
+
+    // The table goes through the same file image grammar_pipeline --ll1 writes
+    Grammar grammar;
+    SymbolId endMarker;
+    if (!loadGrammar(grammar, endMarker, directory + "bench_ll1.txt")) return 1;
+    FirstSets firstSets = computeAllFirst(grammar);
+    LL1Table dense(grammar, firstSets, computeFollow(grammar, firstSets, endMarker));
+    if (!dense.isLL1()) {
+        cout << "Benchmark grammar is not LL(1)" << endl;
+        return 1;
+    }
+    string image = serializeLL1Table(grammar, compressTable(dense));
+    LL1TableFile table;
+    if (!table.attach(image.data(), image.size())) {
+        cout << "Bad table image" << endl;
+        return 1;
+    }
+
+    string text = generateProgram(megabytes * 1000000);
+    cout << "program (" << text.size() / 1e6 << " MB)\n";
+
+    // Lexing alone, for reference
+    RunCost cost;
+    vector<Token> tokens = measureRun([&]() {
+        vector<Token> lexed;
+        Lexer lexer(text.data(), text.size());
+        for (Token token = lexer.next();; token = lexer.next()) {
+            lexed.push_back(token);
+            if (token.kind == TokenKind::End) break;
+        }
+        return lexed;
+    }, cost);
+    char line[160];
+    snprintf(line, sizeof(line), "  %-28s %12zu tokens %9.2f Mtokens/s %9.4f allocs/token\n", "lexer into an array",
+             tokens.size(), tokens.size() / cost.seconds / 1e6, (double)cost.allocations / tokens.size());
+    cout << line;
+
+    // The parser is built, and its stack grown to the program's depth, before timing
+    LL1Parser parser(table);
+    TokenArraySource warmup{tokens.data(), text.data()};
+    ParseResult reference = parser.parse(warmup);
+    bool ok = reference.accepted;
+
+    ok = measure("lexer + LL(1) parser", [&]() {
+        Lexer source(text.data(), text.size());
+        return parser.parse(source);
+    }).accepted && ok;
+    ok = measure("LL(1) parser over tokens", [&]() {
+        TokenArraySource source{tokens.data(), text.data()};
+        return parser.parse(source);
+    }).accepted && ok;
+
+#ifdef PARSER_BENCH_GENERATED
+    TokenArraySource generatedSource{tokens.data(), text.data()};
+    bench_ll1_parser::Parser<TokenArraySource> generatedLL1(generatedSource);
+    ParseResult generated = measure("generated LL(1) over tokens", [&]() {
+        generatedSource.at = tokens.data();
+        return runGenerated(generatedLL1);
+    });
+    ok = generated.accepted && generated.productions == reference.productions && ok;
+#endif
+
+    Grammar lrGrammar;
+    SymbolId lrEndMarker;
+    if (!loadGrammar(lrGrammar, lrEndMarker, directory + "bench_lr.txt")) return 1;
+    LRTable lrTable = buildLRTable(lrGrammar, lrEndMarker);
+    if (!lrTable.conflicts().empty()) {
+        cout << "Benchmark grammar is not LALR(1)" << endl;
+        return 1;
+    }
+    LRParser lrParser(lrTable, lrGrammar);
+    TokenArraySource lrWarmup{tokens.data(), text.data()};
+    ParseResult lrReference = lrParser.parse(lrWarmup);
+    ok = lrReference.accepted && ok;
+
+    ok = measure("lexer + LALR parser", [&]() {
+        Lexer source(text.data(), text.size());
+        return lrParser.parse(source);
+    }).accepted && ok;
+    ok = measure("LALR parser over tokens", [&]() {
+        TokenArraySource source{tokens.data(), text.data()};
+        return lrParser.parse(source);
+    }).accepted && ok;
+
+#ifdef PARSER_BENCH_GENERATED
+    // Run once untimed so the state stack has grown to the program's depth
+    bench_lr_parser::Parser<TokenArraySource> generatedLR(generatedSource);
+    generatedSource.at = tokens.data();
+    generatedLR.parse();
+    ParseResult generatedReductions = measure("generated LR over tokens", [&]() {
+        generatedSource.at = tokens.data();
+        return runGenerated(generatedLR);
+    });
+    ok = generatedReductions.accepted && generatedReductions.productions == lrReference.productions && ok;
+#endif
+    if (!ok) cout << "Program was rejected, or the parsers disagree!" << endl;
+    return ok ? 0 : 1;
+}
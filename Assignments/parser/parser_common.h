@@ -0,0 +1,99 @@
+#ifndef PARSER_COMMON_H
+#define PARSER_COMMON_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../Assignment_2/lexer.h"
+
+// Pieces shared by the table-driven parsers: the token to terminal mapping
+// and the result of a parse.
+//
+// Tokens map to grammar terminals as follows: identifiers to "id", integers
+// and floats to "num", the end of input to "$", and everything else (reserved
+// words, operators, symbols, "#") to the terminal spelled like the lexeme.
+
+#define PARSER_STACK_RESERVE 4096      // Stack entries reserved before the first parse
+#define PARSER_NO_TERMINAL (-1)        // The token is not a terminal of the grammar
+#define PARSER_LOOKUP_MAX_LENGTH 15    // Longer lexemes are never terminals
+
+struct ParseResult {
+    bool accepted;
+    uint64_t tokens;       // Tokens consumed, the end marker included
+    uint64_t productions;  // Productions applied: expansions (LL) or reductions (LR)
+    Token errorToken;      // Where the parse stopped, if not accepted
+    int32_t stackTop;      // Top of the stack at the error: a table symbol (LL) or a state (LR)
+};
+
+// Function to describe where a parse stopped, e.g. "line 3, col 7: unexpected ')'"
+inline std::string describeUnexpected(const ParseResult& result, std::string_view lexeme) {
+    std::string text = "line " + std::to_string(result.errorToken.line) + ", col " +
+                       std::to_string(result.errorToken.col) + ": unexpected ";
+    text += result.errorToken.kind == TokenKind::End ? std::string("end of input") : "'" + std::string(lexeme) + "'";
+    return text;
+}
+
+// Terminal index by name for the terminals a token can stand for, in a small
+// open-addressed hash table; the names must outlive the map
+class TerminalMap {
+public:
+    // nameOf(t) gives the name of terminal t, for t below terminalCount
+    template <typename NameOf>
+    TerminalMap(size_t terminalCount, NameOf nameOf) {
+        size_t slotCount = 16;
+        while (slotCount < 2 * terminalCount) slotCount *= 2;
+        slots.assign(slotCount, PARSER_NO_TERMINAL);
+        slotMask = slotCount - 1;
+        for (size_t t = 0; t < terminalCount; ++t) {
+            std::string_view name = nameOf(t);
+            names.push_back(name);
+            if (name.size() > PARSER_LOOKUP_MAX_LENGTH) continue;
+            uint32_t slot = hash(name.data(), name.size()) & slotMask;
+            while (slots[slot] != PARSER_NO_TERMINAL) slot = (slot + 1) & slotMask;
+            slots[slot] = (int32_t)t;
+        }
+        endTerminal = lookup("$", 1);
+        identifierTerminal = lookup("id", 2);
+        numberTerminal = lookup("num", 3);
+    }
+
+    // Function to find the terminal a token stands for
+    int32_t terminalOf(const Token& token, std::string_view lexeme) const {
+        switch (token.kind) {
+        case TokenKind::End: return endTerminal;
+        case TokenKind::Identifier: return identifierTerminal;
+        case TokenKind::Integer:
+        case TokenKind::Float: return numberTerminal;
+        case TokenKind::Error: return PARSER_NO_TERMINAL;
+        default: return lookup(lexeme.data(), lexeme.size());
+        }
+    }
+
+    int32_t end() const { return endTerminal; }
+
+private:
+    std::vector<std::string_view> names;
+    std::vector<int32_t> slots;
+    uint32_t slotMask;
+    int32_t endTerminal, identifierTerminal, numberTerminal;
+
+    static uint32_t hash(const char* p, size_t n) {
+        uint32_t h = 2166136261u;
+        for (size_t i = 0; i < n; ++i) h = (h ^ (unsigned char)p[i]) * 16777619u;
+        return h;
+    }
+
+    int32_t lookup(const char* p, size_t n) const {
+        if (n > PARSER_LOOKUP_MAX_LENGTH) return PARSER_NO_TERMINAL;
+        for (uint32_t slot = hash(p, n) & slotMask;; slot = (slot + 1) & slotMask) {
+            int32_t t = slots[slot];
+            if (t == PARSER_NO_TERMINAL) return PARSER_NO_TERMINAL;
+            if (names[t].size() == n && memcmp(names[t].data(), p, n) == 0) return t;
+        }
+    }
+};
+
+#endif